@@ -28,11 +28,15 @@ the source code.
 #include <util/delay.h>
 
 #include "lcd.h"
+#include "lcdfb.h"
 #include "gpio.h"
 #include "uart.h"
 #include "rtc.h"
 #include "i2c.h"
 #include "ds18b20.h"
+#include "swtimer.h"
+#include "sound.h"
+#include "keypad.h"
 
 
 /**
@@ -44,67 +48,19 @@ the source code.
 #define  LED2    PORTF, 2, H
 #define  LED3    PORTF, 3, H
 
-#define  BIP     PORTB, 0, H
-//!< Излучатель звука.
-
-/**
- \brief  Определения для клавиатуры.
- */
-#define ROWS	(PIND>>4)				//!< Макрос возвращает состояние строк.
-#define COLUMNS PORTG					//!< Определение для столбцов клавиатуры.
-#define SCAN_COLUMM(collum)			\
-{	COLUMNS |= 0x07;				\
-	COLUMNS &= ~(1<<(collum));		\
-	_delay_loop_1(1);}					//!< Макрос подает на ноль на указанный столбец.
-
-/**
- \brief  Массив для перевода кода нажатия клавиши в ASCII.
- \note '\n'	-- не нажата ни одна клавиша.
- */
-const char keyChars[] =
-{ 	'1', '2', '3',
-	'4', '5', '6',
-	'7', '8', '9',
-	'*', '0', '#',
-		'\n' };
-/**
- \brief  Макрос возвращает ASCII код нажатой клавиши.
- */
-#define getKeyChar() keyChars[getKey()-1]
-
-/**
- \brief  Функция опрашивает клавиатуру.
- \return Номер нажатой клавиши.
- \return 13 -- не нажата ни одна клавиша.
- */
-uint8_t getKey() {
-	uint8_t column, row;
-
-	for (column = 0; column < 3; column++) {
-		SCAN_COLUMM(column);
-		for (row = 0; row < 4; row++) {
-			if (!(ROWS & (1 << row)))
-				return (row * 3 + column + 1);
-		}
-	}
-	return 13;
-}
-
 volatile uint8_t key_mode;		//!< Переменная определяет режим работы программы.
 
-ISR(TIMER3_OVF_vect)			//!< Прерырвание по переполнению Таймера3.
-{
-	tg(BIP);					// Меняем состояние вывода BIP на противоположное.
-	TCNT3 = -8000;
-}
+#define KEY_MODE_TIMEOUT	1000	//!< Время бездействия до выхода из режима набора, мс.
+#define BEEP_FREQ			1000	//!< Частота звукового сигнала, Гц.
+#define BEEP_TIME			200		//!< Длительность звукового сигнала, мс.
 
-ISR(TIMER4_OVF_vect)			//!< Прерырвание по переполнению Таймера4.
+void key_timeout_cb(void *arg)	//!< Истекло время бездействия в режиме набора.
 {
-	TCCR4B_struct.cs4 = 0;		// Выключаем таймер;
-	TIMSK4 = 0;					// запрещаем все прерывания от этого таймера.
 	key_mode = 0;				// Завершаем режим набора текста.
 }
 
+swtimer_t key_timer = SWTIMER_INIT(key_timeout_cb, NULL);
+
 void uart_rx_cb(uint8_t ch) {	//!< Функция обратного вызова для приема байта по uart.
 	if ((ch == '\n') || (ch == '\r')) {
 		uart_putchar('\r', NULL);
@@ -116,29 +72,18 @@ void uart_rx_cb(uint8_t ch) {	//!< Функция обратного вызов
 int main() {
 	//! Инициализация портов для светодиодов.
 	DDRF |= (1 << DDF0 | 1 << DDF1 | 1 << DDF2 | 1 << DDF3);
-	//! Инициализация порта для пьезоизлучателя.
-	DDRB |= (1 << DDB0);
-	//! Инициализация портов для строк клавиатуры. Строки на ввод.
-	DDRD &= ~(1 << DDD4 | 1 << DDD5 | 1 << DDD6 | 1 << DDD7);
-	//! Инициализация портов для строк клавиатуры. Поддяжка к питанию.
-	PORTD |= (1 << PD4 | 1 << PD5 | 1 << PD6 | 1 << PD7);
-	//! Инициализация портов для столбцоы клавиатуры. столбцы на вывод.
-	DDRG |= (1 << DDG0 | 1 << DDG1 | 1 << DDG2);
 
-	//! Инициализация таймера для излучателя звука.
-	TCCR3A = 0;
-	TCCR3A = 0;
-	TCCR3B = 0;
-	TCCR3B_struct.cs3 = 0x01;		// Предделитель: F_CPU/1
-	TIMSK3_struct.toie3 = 1;		// Разрешаем прерывание по переполнению
-	TCNT3 = -8000;					// 8000 тактов центрального проессора ~ 500 мкс.
-
-	//! Инициализация таймера для смены режимов.
-	TCCR4A = 0;
-	TCCR4A = 0;
-	TCCR4B = 0;
-
-	uint8_t key1, key2 = 0;			//!< Переменные для хранения кода нажатых клавишь.
+	//! Программные таймеры: выход из режима набора, длительности звука, опрос клавиатуры.
+	swtimerInit();
+	//! Клавиатура опрашивается в фоне, нажатия копятся в очереди.
+	keypadInit();
+	//! Излучатель звука; сигнал при запуске звучит в фоне.
+	soundInit();
+	soundBeep(BEEP_FREQ, 750);
+
+	keypad_event_t key_ev;			//!< Событие клавиатуры.
+	uint8_t have_ev = 0;			//!< key_ev уже прочитано, но не обработано.
+	uint8_t key1;					//!< Символ нажатой клавиши.
 	uint8_t i;
 	char tx_buff_str[16];
 
@@ -190,23 +135,23 @@ int main() {
 	ds18b20_read(&ds18b20_memory);				//!< Читаем температуру.
 	sec = time.Second;
 
-	TIMSK3_struct.toie3 = 0;// Запрещаем прерывание при переполнении таймера 3.
-	off(BIP);									// Выключаем звук.
-
 	lcdClear(&lcd);
 	lcdCursor(&lcd, 1);
 	lcdPuts(&lcd, "Text:\n");
+
+	//! Экранный буфер: часы и температура выводятся только изменившимися символами.
+	lcdfb_t fb;
+	lcdfbInit(&fb, &lcd);
 	while (1) {
 		while (key_mode)		// В режиме набора текст:
 		{
-			key1 = getKeyChar();
-			for(i=0; i<5; i++) _delay_ms(10);
-			key2 = getKeyChar();
-
-			if (key1 == '\n') continue;
-			else if (key1 != key2) continue;
+			if (!have_ev && !keypadGetEvent(&key_ev)) continue;
+			have_ev = 0;
+			// Символ -- при нажатии и автоповторе при удержании.
+			if ((key_ev.type != KEYPAD_PRESS) && (key_ev.type != KEYPAD_REPEAT)) continue;
+			key1 = keypadChar(key_ev.key);
 
-			TCNT4 = 0;				// Дополнительное время работы в этом режиме
+			swtimerStart(&key_timer, KEY_MODE_TIMEOUT, 0);	// Дополнительное время работы в этом режиме
 			if((lcd.cx) == lcd.cols)// закончились символы в строке
 			{
 				lcdPuts(&lcd,"\r        \r");// стираем строку, возвращаем курсор в начало
@@ -216,15 +161,13 @@ int main() {
 			LEDS &= ~0x0F;
 			LEDS |= 0x0F&key1;
 			putchar(key1);
-			TIMSK3_struct.toie3 = 1;			// пик
-			for(i=0; i<20; i++) _delay_ms(10);
-			TIMSK3_struct.toie3 = 0;
+			soundBeep(BEEP_FREQ, BEEP_TIME);	// пик
 		}
 
 		printf("\r\033[0K%02u:%02u:%02u",time.Hour, time.Minute ,time.Second);
 		sprintf(tx_buff_str, "%02u:%02u:%02u\n",time.Hour, time.Minute ,time.Second);
-		lcdHome(&lcd);
-		lcdPuts(&lcd, tx_buff_str);
+		lcdfbPosition(&fb, 0, 0);
+		lcdfbPuts(&fb, tx_buff_str);
 
 		if(ds18b20_crc8((uint8_t *)&ds18b20_memory, sizeof(ds18b20_memory)))
 		fprintf(stderr,"ERROR read DS18B20\r\n");
@@ -233,8 +176,9 @@ int main() {
 			temper = (ds18b20_memory.temper_MSB << 8) | ds18b20_memory.temper_LSB;
 			printf(" T= %d.%u",temper>>4, ((temper&0xf)*1000)/(16));
 			sprintf(tx_buff_str,"%02d.%u%cC  ",temper>>4, ((temper&0xf)*1000)/(16), 0x01);
-			lcdPuts(&lcd, tx_buff_str);
+			lcdfbPuts(&fb, tx_buff_str);
 		}
+		lcdfbFlush(&fb);
 
 		ds18b20_convert();		// Запуск преобразование температуры.
 		while(sec == time.Second)
@@ -245,17 +189,16 @@ int main() {
 				continue;
 			}
 
-			key1 = getKeyChar();
-			if (key1 != '\n')
+			if (keypadGetEvent(&key_ev) && (key_ev.type == KEYPAD_PRESS))
 			{
 				key_mode = 1;
+				have_ev = 1;			// Это нажатие -- первый символ текста.
 				lcdClear(&lcd);
+				lcdfbInvalidate(&fb);	// Экран перерисуем целиком после режима набора.
 				lcdCursor(&lcd, 1);
 				lcdPuts(&lcd,"Text:\n");
 
-				TCCR4B_struct.cs4 = 0x04;		// Предделитель: F_CPU/256
-				TIMSK4_struct.toie4 = 1;// Разрешаем прерывание по переполнению
-				TCNT4 = 0;
+				swtimerStart(&key_timer, KEY_MODE_TIMEOUT, 0);
 				printf("\r\033[0K");// стираем строку в терминале
 				break;
 			}
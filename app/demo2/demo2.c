@@ -34,6 +34,7 @@ the source code.
 #include "i2c.h"
 #include "ds18b20.h"
 #include "timer.h"
+#include "timer_inline.h"
 
 
 /**
@@ -96,13 +97,13 @@ volatile uint8_t key_mode;		//!< Переменная определяет ре
 ISR(TIMER3_OVF_vect)			//!< Прерырвание по переполнению Таймера3.
 {
 	tg(BIP);					// Меняем состояние вывода BIP на противоположное.
-	timer_3.setCNT(-8000);
+	timer3_setCNT(-8000);		// Прямая запись в TCNT3, без вызова через указатель.
 }
 
 ISR(TIMER4_OVF_vect)			//!< Прерырвание по переполнению Таймера4.
 {
-	timer_4.stop_timer(); // Выключаем таймер;
-	timer_4.clearTimerInterruptFlag(TIMER_OVERFLOW_INT); // запрещаем все прерывания от этого таймера.
+	timer4_stop(); // Выключаем таймер;
+	timer4_clearInterrupt(TIMER_OVERFLOW_INT); // запрещаем все прерывания от этого таймера.
 	key_mode = 0;				// Завершаем режим набора текста.
 }
 
@@ -127,10 +128,13 @@ int main() {
 	DDRG |= (1 << DDG0 | 1 << DDG1 | 1 << DDG2);
 
 	//! Инициализация таймера для излучателя звука.
-	timer_3.clear();
-	timer_3.setTimerInterruptFlag(TIMER_OVERFLOW_INT);
-	timer_3.setCNT(-8000);
-	timer_3.start_timer(CLK_DIV_1);
+	//! Если таймер занят другим модулем, звука не будет.
+	if (timer_3.clear() == 0)
+	{
+		timer_3.setTimerInterruptFlag(TIMER_OVERFLOW_INT);
+		timer_3.setCNT(-8000);
+		timer_3.start_timer(CLK_DIV_1);
+	}
 
 	//! Инициализация таймера для смены режимов.
 	timer_4.clear();
@@ -33,6 +33,7 @@ int main()
 		ds18b20_convert();				// Запускаем преобразование температуры.
 		// Ждем команды.
 		uart_getchar(NULL);
+		ds18b20_wait();					// Ждем, если преобразование еще не завершено.
 		ds18b20_read(&ds18b20_memory);	// Читаем температуру.
 
 		// Проверяем контрольную сумму считанных из датчика данных.
@@ -5,6 +5,10 @@
  \details
  Программа Программа отправляет в эфир принятую по uart (8-бит, 115200 бит/с)
  строку. Принятая по радио строка, отправляется по uart.
+ Строки длиннее одного кадра (до LINE_SIZE байт) передаются транспортом
+ rftp.h по фрагментам; пока строка передается, ввод не принимается.
+ Короткая строка идет одним кадром с байтом типа CHAT_TEXT впереди, чтобы
+ текст не путался с кадрами rftp.
  \version   0.1
  \date 24.10.2015
  \copyright
@@ -25,6 +29,8 @@ the source code.
 #include <util/delay.h>
 #include "gpio.h"
 #include "uart.h"
+#include "rf.h"
+#include "rftp.h"
 
 //  Определения для светодиодов.
 #define LEDS (PORTF)
@@ -33,85 +39,87 @@ the source code.
 #define  LED2    PORTF, 2, H
 #define  LED3    PORTF, 3, H
 
-#define RF_BUFFER_SIZE (127)
-char rf_RX_buffer[RF_BUFFER_SIZE];
-char rf_TX_buffer[RF_BUFFER_SIZE];
+#define LINE_SIZE (1024)			//!< Наибольшая длина строки.
+#define CHAT_TEXT (0x01)			//!< Тип кадра со строкой (кадры rftp -- 0xA1..0xA3).
+char line_TX_buffer[LINE_SIZE];
+char line_RX_buffer[LINE_SIZE];
 
-uint8_t uart_rx_ptr = 0;
+// Состояния строки ввода.
+#define LINE_EDIT	0				//!< Набирается.
+#define LINE_READY	1				//!< Набрана, ждет отправки.
+#define LINE_RFTP	2				//!< Передается rftp (буфер занят).
 
-void rf_init(void)
-{
-	// Сбрасываем регистры трансивера и конечный автомат.
-	TRXPR |= (1<<TRXRST);
-	// Разрешаем прерывания.
-	IRQ_MASK = (1<<RX_END_EN) | (1<<TX_END_EN);
-	// Переводим приемопередатчик в режим приема.
-	TRX_STATE = CMD_RX_ON;
-	// Ждем, пока установится состояние.
-	while (((TRX_STATUS)& 0x1F) != RX_ON);
-}
-
-void rf_send(const void *data, uint8_t len)
-{
-	on(LED0);
-	// Переводим приемопередатчик в режим передачи.
-	TRX_STATE = CMD_PLL_ON;
-	// Ждем, пока установится состояние.
-	while (((TRX_STATUS)& 0x1F) != PLL_ON);
-
-	// В первый байт записываем длинну пакета.
-	TRXFBST = len + 2;
-	// Копируем пакет в буфер передатчика.
-	memcpy((void *)(&TRXFBST+1), data, len);
-
-	// Запускаем передачу.
-	TRX_STATE = CMD_TX_START;
-}
-
-// Обработчик прерывания. Конец передачи пакета.
-ISR(TRX24_TX_END_vect)
-{
-	off(LED0);
-	// Переводим приемопередатчик в режим приема.
-	TRX_STATE = CMD_RX_ON;
-}
+volatile uint16_t uart_rx_ptr = 0;
+volatile uint8_t line_state = LINE_EDIT;
 
-// Обработчик прерывания. Пакет принят полностью.
-ISR(TRX24_RX_END_vect)
+//!< Функция вызывается из rf_task(), когда принят кадр.
+void rf_rx_cb(rf_rx_frame_t *f)
 {
-	uint8_t length;
-	tg(LED2);
-
-	// Проверка контрольной суммы пакета.
-	if(PHY_RSSI & (1<<RX_CRC_VALID))
-	{	// Проверка контрольной суммы пакета.
+	if (rftp_input(f))				// Фрагмент длинной строки.
+		return;
+	if (f->len && (f->data[0] == CHAT_TEXT))
+	{
 		tg(LED3);
-		length = TST_RX_LENGTH - 2;
-		// Копируем буфер приемника
-		memcpy(rf_RX_buffer, (void*)&TRXFBST, length);
-		rf_RX_buffer[length] = '\0';
-		printf("> %s\n",rf_RX_buffer);
+		printf("> %.*s [%d dBm, LQI %u]\n", f->len - 1, (const char *)f->data + 1, f->rssi, f->lqi);
 	}
+	rf_release(f);
 }
 
 //!< Функция вызывается, когда принят по uart байт.
 void uart_rx_cb(uint8_t ch)
 {
-	rf_TX_buffer[uart_rx_ptr++] = ch;
-	if(uart_rx_ptr == RF_BUFFER_SIZE) uart_rx_ptr = 0;
+	if (line_state != LINE_EDIT)	// Предыдущая строка еще передается.
+	{
+		uart_putchar('\a', NULL);
+		return;
+	}
+	line_TX_buffer[uart_rx_ptr++] = ch;
 
-	if ((ch == '\n') || (ch == '\r'))
+	if ((ch == '\n') || (ch == '\r') || (uart_rx_ptr == LINE_SIZE))
 	{
 		uart_putchar('\r', NULL);
 		uart_putchar('\n', NULL);
-		rf_send(rf_TX_buffer, uart_rx_ptr);
-		uart_rx_ptr = 0;
+		line_state = LINE_READY;	// Отправка -- в основном цикле.
 	} else
 	{
 		uart_putchar(ch, NULL);
 	}
 }
 
+/**
+\brief Отправить набранную строку: короткую -- одним кадром, длинную -- rftp.
+*/
+void send_line(void)
+{
+	uint8_t frame[RF_MAX_PAYLOAD];
+
+	if (line_state == LINE_READY)
+	{
+		if (uart_rx_ptr > rf_max_payload() - 1)
+		{
+			if (rftp_send(line_TX_buffer, uart_rx_ptr) == 0)
+				line_state = LINE_RFTP;
+			return;
+		}
+		if (!rf_tx_free())
+			return;					// Очередь полна, повторим.
+		frame[0] = CHAT_TEXT;
+		memcpy(&frame[1], line_TX_buffer, uart_rx_ptr);
+		rf_send(frame, uart_rx_ptr + 1);
+	}
+	else if (line_state == LINE_RFTP)
+	{
+		if (rftp_tx_status() == RFTP_BUSY)
+			return;
+		if (rftp_tx_status() == RFTP_FAILED)
+			printf("rftp: no answer\r\n");
+	}
+	else
+		return;
+	uart_rx_ptr = 0;
+	line_state = LINE_EDIT;
+}
+
 int main() 
 {
 	//! Инициализация портов для светодиодов.
@@ -125,8 +133,29 @@ int main()
 
 	// Инициализация радио трансивера.
 	rf_init();
+	rf_set_rx_cb(rf_rx_cb);
+	rftp_init();
+	rftp_listen(line_RX_buffer, sizeof(line_RX_buffer), NULL);
 
-	while(1);
+	while(1)
+	{
+		rf_task();
+		rftp_task();
+		send_line();
+		if (rftp_rx_status() == RFTP_DONE)
+		{
+			tg(LED3);
+			printf(">> %.*s\n", (int)rftp_rx_length(), line_RX_buffer);
+			rftp_listen(line_RX_buffer, sizeof(line_RX_buffer), NULL);
+		}
+		else if (rftp_rx_status() == RFTP_FAILED)
+		{
+			printf("rftp: line lost\r\n");
+			rftp_listen(line_RX_buffer, sizeof(line_RX_buffer), NULL);
+		}
+		if (rf_tx_busy()) on(LED0);
+		else off(LED0);
+	}
 
 	return 0;
 }
@@ -0,0 +1,269 @@
+/**
+ \file
+ \author agent <agent@local>
+ \brief Измерение скорости радиоканала ATMEGA128RFA1 на разных скоростях.
+ \details
+ Программа измеряет полезную скорость (goodput) и долю потерянных кадров
+ для режимов 250 кбит/с, 500 кбит/с, 1 Мбит/с и 2 Мбит/с. Результаты
+ выводятся в uart (8-бит, 115200 бит/с). Команды по uart:
+ - 't' -- передатчик: для каждой скорости отправляет серию кадров и
+ получает отчет от приемника. Вторая плата должна быть приемником;
+ - 'l' -- одна плата: только передача, без приемника. Показывает, сколько
+ успевает передать сам узел (верхняя граница), потери не измеряются;
+ - по умолчанию плата -- приемник.
+
+ Перед серией передатчик на 250 кбит/с сообщает скорость и число кадров
+ (кадр 'C'), затем оба переходят на эту скорость. Приемник считает кадры
+ данных ('D') и время от первого до последнего; через RX_TIMEOUT_US после
+ последнего кадра возвращается на 250 кбит/с и отправляет отчет ('R').
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов. Эта лицензия дает
+все права на использование и распространение программы в двоичном виде или
+в виде исходного кода, при условии, что в исходном коде сохранится указание
+авторских прав.
+
+This software is licensed under the simplified BSD license. This license gives
+everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include <util/delay.h>
+#include "gpio.h"
+#include "uart.h"
+#include "rf.h"
+#include "clock.h"
+
+//  Определения для светодиодов.
+#define  LED0    PORTF, 0, H
+#define  LED1    PORTF, 1, H
+
+#define BURST_FRAMES	(200)			//!< Кадров в серии.
+#define RX_TIMEOUT_US	(100000UL)		//!< Конец серии: нет кадров 100 мс.
+#define REPORT_WAIT_US	(500000UL)		//!< Сколько передатчик ждет отчет.
+
+static const char *rate_name[] = { "250k", "500k", "1M", "2M" };
+
+volatile uint8_t command;				//!< Последняя команда из uart.
+
+/**
+ \brief  Состояние приемника и отчета.
+ */
+static uint8_t rx_rate;					//!< Скорость текущей серии.
+static uint8_t rx_burst;				//!< Идет серия.
+static int8_t rate_pending = -1;		//!< Скорость, на которую перейти в основном цикле; -1 -- нет.
+static uint8_t rx_len;					//!< Длина кадров данных серии.
+static uint16_t rx_expected, rx_count;
+static uint32_t rx_first, rx_last;		//!< Время первого и последнего кадра, мкс.
+
+static uint8_t report_ok;				//!< Передатчик получил отчет.
+static uint16_t report_count;
+static uint32_t report_time;
+
+/**
+\brief Полезная скорость.
+\param len Длина кадра данных.
+\return кбит/с.
+*/
+static uint32_t goodput(uint16_t frames, uint8_t len, uint32_t us)
+{
+	if (!us)
+		return 0;
+	return ((uint32_t)frames * len * 8 * 1000UL) / us;
+}
+
+//!< Функция вызывается из rf_task(), когда принят кадр.
+//!< Скорость здесь не меняем: rf_set_rate() ждет очередь через rf_task().
+void rf_rx_cb(rf_rx_frame_t *f)
+{
+	const uint8_t *data = f->data;
+	uint8_t len = f->len;
+	uint32_t now = f->time;			// Время приема, а не обработки.
+
+	switch (data[0])
+	{
+	case 'C':			// Начало серии: скорость и число кадров.
+		if (len < 4) break;
+		rx_rate = data[1] & 0x03;
+		rx_expected = data[2] | (data[3] << 8);
+		rx_count = 0;
+		rx_burst = 1;
+		rx_last = now;
+		rate_pending = rx_rate;
+		on(LED1);
+		break;
+	case 'D':			// Кадр данных.
+		if (!rx_burst) break;
+		if (!rx_count) rx_first = now;
+		rx_len = len;
+		rx_count++;
+		rx_last = now;
+		break;
+	case 'R':			// Отчет приемника.
+		if (len < 7) break;
+		report_count = data[1] | (data[2] << 8);
+		memcpy(&report_time, &data[3], 4);
+		report_ok = 1;
+		break;
+	}
+	rf_release(f);
+}
+
+//!< Функция вызывается, когда принят по uart байт.
+void uart_rx_cb(uint8_t ch)
+{
+	command = ch;
+}
+
+/**
+\brief Приемник: конец серии по тайм-ауту, отчет передатчику.
+*/
+static void receiverTask(void)
+{
+	uint8_t report[7];
+	uint32_t elapsed;
+	uint16_t per;
+
+	if (rate_pending >= 0)			// Серия объявлена: переходим на ее скорость.
+	{
+		rf_set_rate(rate_pending);
+		rate_pending = -1;
+	}
+	if (!rx_burst || (clockMicros() - rx_last < RX_TIMEOUT_US))
+		return;
+	rx_burst = 0;
+	off(LED1);
+	rf_set_rate(RF_RATE_250K);
+	elapsed = rx_count ? (rx_last - rx_first) : 0;
+	per = (rx_count < rx_expected) ?		// Потери, десятые доли процента.
+		(uint16_t)((rx_expected - rx_count) * 1000UL / rx_expected) : 0;
+	printf("RX %4s: %u/%u frames, PER %u.%u%%, %lu kbit/s\r\n", rate_name[rx_rate],
+		rx_count, rx_expected, per / 10, per % 10,
+		goodput(rx_count > 1 ? rx_count - 1 : 0, rx_len, elapsed));	// Первый кадр -- отметка начала.
+	report[0] = 'R';
+	report[1] = rx_count;
+	report[2] = rx_count >> 8;
+	memcpy(&report[3], &elapsed, 4);
+	rf_send(report, sizeof(report));
+}
+
+/**
+\brief Передать серию кадров на скорости rate.
+\param len Длина кадра данных.
+\return Время передачи, мкс; 0 -- драйвер не принял кадр.
+*/
+static uint32_t sendBurst(uint8_t rate, uint8_t len)
+{
+	uint8_t frame[RF_MAX_PAYLOAD];
+	uint16_t seq;
+	uint32_t t0;
+	int8_t r;
+
+	rf_set_rate(rate);
+	memset(frame, 0x55, len);
+	frame[0] = 'D';
+	t0 = clockMicros();
+	for (seq = 0; seq < BURST_FRAMES; seq++)
+	{
+		frame[1] = seq;
+		frame[2] = seq >> 8;
+		while ((r = rf_send(frame, len)) == -1)	// Очередь полна -- ждем.
+			rf_task();
+		if (r == -2)					// Длина не подходит режиму.
+		{
+			rf_set_rate(RF_RATE_250K);
+			return 0;
+		}
+	}
+	while (rf_tx_busy())
+		rf_task();
+	t0 = clockMicros() - t0;
+	rf_set_rate(RF_RATE_250K);
+	return t0;
+}
+
+/**
+\brief Передатчик: серии на всех скоростях.
+\param loopback 1 -- одна плата, без приемника и отчетов.
+*/
+static void transmitter(uint8_t loopback)
+{
+	uint8_t ctrl[4];
+	uint8_t rate, len = rf_max_payload();	// Наибольший кадр в текущем режиме.
+	uint32_t t, wait;
+
+	for (rate = RF_RATE_250K; rate <= RF_RATE_2M; rate++)
+	{
+		on(LED0);
+		if (!loopback)
+		{
+			ctrl[0] = 'C';
+			ctrl[1] = rate;
+			ctrl[2] = (uint8_t)BURST_FRAMES;
+			ctrl[3] = BURST_FRAMES >> 8;
+			rf_send(ctrl, sizeof(ctrl));
+			while (rf_tx_busy())
+				rf_task();
+			_delay_ms(5);				// Приемник переключает скорость.
+		}
+		t = sendBurst(rate, len);
+		off(LED0);
+		if (!t)
+		{
+			printf("TX %4s: frame length %u rejected\r\n", rate_name[rate], len);
+			return;
+		}
+		printf("TX %4s: %u frames of %u bytes in %lu us, %lu kbit/s\r\n", rate_name[rate],
+			BURST_FRAMES, len, t, goodput(BURST_FRAMES, len, t));
+		if (loopback)
+			continue;
+
+		report_ok = 0;
+		wait = clockMicros();
+		while (!report_ok && (clockMicros() - wait < REPORT_WAIT_US))
+			rf_task();
+		if (report_ok)
+			printf("   report: %u/%u frames, PER %u%%, %lu kbit/s\r\n",
+				report_count, BURST_FRAMES,
+				(uint16_t)((BURST_FRAMES - report_count) * 100UL / BURST_FRAMES),
+				goodput(report_count > 1 ? report_count - 1 : 0, len, report_time));
+		else
+			printf("   no report\r\n");
+	}
+	printf("sent %u, dropped %u\r\n", rf_stats.tx_ok, rf_stats.tx_dropped);
+}
+
+int main()
+{
+	//! Инициализация портов для светодиодов.
+	DDRF |= (1 << DDF0 | 1 << DDF1 | 1 << DDF2 | 1 << DDF3);
+	uart_init();						//!< Инициализируем UART.
+	uart_set_input_cb(uart_rx_cb);
+	clockInit();						//!< Отметки времени, мкс.
+
+	printf("LESO6 ATMEGA128RFA1 radio benchmark\r\n");
+	printf("t -- transmitter, l -- single board TX only, default -- receiver\r\n");
+
+	rf_init();
+	rf_set_rx_cb(rf_rx_cb);
+
+	while(1)
+	{
+		rf_task();
+		receiverTask();
+		if (command == 't' || command == 'l')
+		{
+			transmitter(command == 'l');
+			command = 0;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,261 @@
+/**
+ \file capture.c
+ \author agent <agent@local>
+ \brief Измерение периода, частоты и длительности импульсов захватом таймера
+ \details Вся обработка -- в прерываниях захвата и переполнения таймера
+ CAPTURE_TIMER.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+
+#include "timer.h"
+#include "timer_claim.h"
+#include "capture.h"
+
+#if CAPTURE_TIMER != 1 && CAPTURE_TIMER != 3 && CAPTURE_TIMER != 4 && CAPTURE_TIMER != 5
+#error "CAPTURE_TIMER must be 1, 3, 4 or 5"
+#endif
+
+/**
+ \brief  Имена регистров и битов выбранного таймера.
+ */
+#define CAT_(a, n, b)	a##n##b
+#define CAT(a, n, b)	CAT_(a, n, b)
+#define TCCRA		CAT(TCCR, CAPTURE_TIMER, A)
+#define TCCRB		CAT(TCCR, CAPTURE_TIMER, B)
+#define TCNT		CAT(TCNT, CAPTURE_TIMER, )
+#define ICR			CAT(ICR, CAPTURE_TIMER, )
+#define TIMSK		CAT(TIMSK, CAPTURE_TIMER, )
+#define TIFR		CAT(TIFR, CAPTURE_TIMER, )
+#define ICNC		CAT(ICNC, CAPTURE_TIMER, )
+#define ICES		CAT(ICES, CAPTURE_TIMER, )
+#define ICIE		CAT(ICIE, CAPTURE_TIMER, )
+#define ICF			CAT(ICF, CAPTURE_TIMER, )
+#define TOIE		CAT(TOIE, CAPTURE_TIMER, )
+#define TOV			CAT(TOV, CAPTURE_TIMER, )
+#define CAPT_vect	CAT(TIMER, CAPTURE_TIMER, _CAPT_vect)
+#define OVF_vect	CAT(TIMER, CAPTURE_TIMER, _OVF_vect)
+
+#define RING_MASK	(CAPTURE_RING_SIZE - 1)
+
+static volatile uint16_t ring[CAPTURE_RING_SIZE];
+static volatile uint8_t ring_wr, ring_rd;
+
+static volatile uint16_t overflows;		//!< Старшие 16 бит отметок времени.
+static uint8_t cap_mode;
+static uint16_t cap_div;				//!< Предделитель таймера.
+
+static uint32_t last_rise;				//!< Отметка последнего начального перепада.
+static uint32_t last_high;				//!< Длительность первой фазы текущего периода.
+static uint8_t have_rise;				//!< last_rise действительна.
+static uint32_t sum_period, sum_high;	//!< Накопление для усреднения.
+static uint8_t nsum;
+static volatile uint32_t avg_period, avg_high;	//!< Готовые средние.
+
+static uint8_t claimed;					//!< Каналы таймера заняты нами.
+
+static const uint16_t divisors[] = { 0, 1, 8, 64, 256, 1024 };
+
+TIMER_CLAIM_STATIC(CAPTURE_TIMER, CAPT)
+TIMER_CLAIM_STATIC(CAPTURE_TIMER, OVF)
+
+/**
+\brief Переполнение таймера: старшие разряды отметок.
+*/
+ISR(OVF_vect)
+{
+	overflows++;
+}
+
+/**
+\brief Захват: отметка в буфер, период и длительность -- в накопители.
+*/
+ISR(CAPT_vect)
+{
+	uint16_t icr = ICR;
+	uint16_t ovf = overflows;
+	uint32_t t, p;
+	uint8_t falling;
+
+	// Переполнение, еще не обработанное, произошло до захвата, если ICR мал.
+	if ((TIFR & (1 << TOV)) && (icr < 0x8000))
+		ovf++;
+	t = ((uint32_t)ovf << 16) | icr;
+
+	ring[ring_wr] = icr;
+	ring_wr = (ring_wr + 1) & RING_MASK;
+	if (ring_wr == ring_rd)					// Буфер полон -- теряем старую отметку.
+		ring_rd = (ring_rd + 1) & RING_MASK;
+
+	if (cap_mode & CAPTURE_BOTH)
+	{
+		falling = !(TCCRB & (1 << ICES));	// Какой перепад только что захвачен.
+		TCCRB ^= 1 << ICES;					// Следующий -- противоположный.
+		TIFR = 1 << ICF;					// Смена фронта может выставить флаг.
+		if ((cap_mode & CAPTURE_FALLING) ? !falling : falling)
+		{
+			if (have_rise)
+				last_high = t - last_rise;
+			return;
+		}
+	}
+
+	if (have_rise)
+	{
+		p = t - last_rise;
+		sum_period += p;
+		// С CAPTURE_FALLING период начинается спадом, и last_high -- это
+		// низкий уровень: высокий -- остаток периода.
+		if ((cap_mode & (CAPTURE_BOTH | CAPTURE_FALLING)) == (CAPTURE_BOTH | CAPTURE_FALLING))
+			sum_high += p - last_high;
+		else
+			sum_high += last_high;
+		if (++nsum == CAPTURE_AVERAGE)
+		{
+			avg_period = sum_period / CAPTURE_AVERAGE;
+			avg_high = sum_high / CAPTURE_AVERAGE;
+			sum_period = sum_high = 0;
+			nsum = 0;
+		}
+	}
+	last_rise = t;
+	have_rise = 1;
+}
+
+int8_t captureInit(CLOCK_t clk, uint8_t mode)
+{
+	int8_t r;
+
+	captureStop();
+	r = timerClaim(CAPTURE_TIMER, TIMER_CAPTURE_INT | TIMER_OVERFLOW_INT, clk, NORMAL_MODE, "capture");
+	if (r < 0)
+		return r;
+	claimed = 1;
+	if (r == TIMER_CLAIM_FIRST)
+	{
+		TCCRA = 0;
+		TCCRB = 0;
+		TCNT = 0;
+	}
+
+	cap_mode = mode;
+	cap_div = divisors[TO_INT(clk)];
+	overflows = 0;
+	ring_wr = ring_rd = 0;
+	have_rise = 0;
+	sum_period = sum_high = 0;
+	last_high = 0;
+	nsum = 0;
+	avg_period = avg_high = 0;
+
+	// В режиме CAPTURE_BOTH период отсчитывается от перепада, указанного
+	// CAPTURE_FALLING (по умолчанию -- от фронта), с него и начинаем.
+	TCCRB = (TCCRB & ~((1 << ICES) | (1 << ICNC))) |
+			((mode & CAPTURE_FALLING) ? 0 : (1 << ICES)) |
+			((mode & CAPTURE_NOISE_CANCEL) ? (1 << ICNC) : 0);
+	TIFR = (1 << ICF) | (1 << TOV);
+	TIMSK |= (1 << ICIE) | (1 << TOIE);
+	if (r == TIMER_CLAIM_FIRST)
+		TCCRB |= TO_INT(clk);
+	return 0;
+}
+
+void captureStop(void)
+{
+	if (!claimed)
+		return;
+	TIMSK &= ~((1 << ICIE) | (1 << TOIE));
+	timerRelease(CAPTURE_TIMER, TIMER_CAPTURE_INT | TIMER_OVERFLOW_INT);
+	if (!timerOwner(CAPTURE_TIMER))		// Больше никому не нужен.
+		TCCRB &= ~CSx_BITS;
+	claimed = 0;
+}
+
+uint32_t capturePeriod(void)
+{
+	uint8_t sreg = SREG;
+	uint32_t p;
+
+	cli();
+	p = avg_period;
+	SREG = sreg;
+	return p;
+}
+
+uint32_t capturePulseWidth(void)
+{
+	uint8_t sreg = SREG;
+	uint32_t h;
+
+	cli();
+	h = avg_high;
+	SREG = sreg;
+	return h;
+}
+
+uint32_t captureFrequency(void)
+{
+	uint32_t p = capturePeriod();
+
+	if (!p || !cap_div)
+		return 0;
+	return (F_CPU / cap_div + p / 2) / p;
+}
+
+uint16_t captureDuty(void)
+{
+	uint8_t sreg = SREG;
+	uint32_t p, h;
+
+	cli();
+	p = avg_period;
+	h = avg_high;
+	SREG = sreg;
+	if (!p)
+		return 0;
+	// h * 1000 должно поместиться в 32 бита: уменьшаем обе величины.
+	while (h > 0x003FFFFFUL)
+	{
+		h >>= 1;
+		p >>= 1;
+	}
+	return (h * 1000 + p / 2) / p;
+}
+
+uint32_t captureTicksToUs(uint32_t ticks)
+{
+	if (!cap_div)							// captureInit() не вызывалась.
+		return 0;
+	if (cap_div >= F_CPU / 1000000UL)		// Предделители кратны частоте в МГц.
+		return ticks * (cap_div / (F_CPU / 1000000UL));
+	return ticks / ((F_CPU / 1000000UL) / cap_div);
+}
+
+uint8_t captureRead(uint16_t *buf, uint8_t max)
+{
+	uint8_t n = 0;
+	uint8_t sreg = SREG;
+
+	cli();
+	while ((n < max) && (ring_rd != ring_wr))
+	{
+		buf[n++] = ring[ring_rd];
+		ring_rd = (ring_rd + 1) & RING_MASK;
+	}
+	SREG = sreg;
+	return n;
+}
@@ -0,0 +1,134 @@
+/**
+ \file capture.h
+ \author agent <agent@local>
+ \brief Измерение периода, частоты и длительности импульсов захватом таймера
+ \details Модуль использует блок захвата (ICP) одного из 16-битных таймеров
+ (CAPTURE_TIMER). Таймер считает непрерывно, переполнения расширяют отметки
+ времени до 32 бит. Прерывание захвата:
+ - кладет 16-битные значения ICR в кольцевой буфер (captureRead());
+ - считает период и длительность импульса и усредняет их по
+ CAPTURE_AVERAGE периодам.
+
+ Основная программа только читает готовые средние значения.
+\code{.c}
+	captureInit(CLK_DIV_8, CAPTURE_BOTH | CAPTURE_NOISE_CANCEL);
+	sei();
+	...
+	printf("f = %lu Hz, duty = %u.%u %%\r\n", captureFrequency(),
+		captureDuty() / 10, captureDuty() % 10);
+\endcode
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include <stdint.h>
+#include "timer.h"
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Номер таймера: 1, 3, 4 или 5.
+ \details Вход захвата таймера 3 -- вывод PE7 (ICP3). Таймер 1 занят часами
+ (clock.h), таймер 5 -- программными таймерами (swtimer.h).
+ */
+#define CAPTURE_TIMER		3
+
+/**
+ \brief  Размер кольцевого буфера отметок (степень двойки).
+ */
+#define CAPTURE_RING_SIZE	(16)
+
+/**
+ \brief  По скольким периодам усреднять (степень двойки, не больше 128).
+ */
+#define CAPTURE_AVERAGE		(8)
+/*************************************************************************/
+
+/**
+ \brief  Режимы захвата (можно объединять через |).
+ */
+#define CAPTURE_RISING			0x00	//!< Захват по фронту.
+#define CAPTURE_FALLING			0x01	//!< Захват по спаду.
+#define CAPTURE_BOTH			0x02	//!< Оба перепада: период, длительность и скважность.
+#define CAPTURE_NOISE_CANCEL	0x04	//!< Подавитель помех (задержка 4 такта F_CPU).
+
+/**
+\brief Запуск измерений.
+\details Занимает захват и переполнение таймера CAPTURE_TIMER (нормальный
+режим, см. timer_claim.h) и разрешает их прерывания. Для работы нужны
+разрешенные прерывания. Повторный вызов перезапускает измерения.
+\param clk Предделитель таймера; определяет разрешение и наибольший период.
+\param mode Режим захвата: CAPTURE_RISING, CAPTURE_FALLING или CAPTURE_BOTH,
+ и, при необходимости, CAPTURE_NOISE_CANCEL.
+\return 0 -- успешно; меньше нуля -- таймер занят несовместимо (код timerClaim()).
+*/
+int8_t captureInit(CLOCK_t clk, uint8_t mode);
+
+/**
+\brief Остановка измерений.
+\details Освобождает каналы таймера; таймер останавливается, если им
+больше никто не пользуется.
+*/
+void captureStop(void);
+
+/**
+\brief Средний период.
+\return Период в отсчетах таймера; 0 -- еще не набрано CAPTURE_AVERAGE периодов.
+*/
+uint32_t capturePeriod(void);
+
+/**
+\brief Средняя длительность импульса (высокого уровня).
+\details Только в режиме CAPTURE_BOTH. С CAPTURE_FALLING период
+отсчитывается от спада, но возвращается все равно высокий уровень.
+\return Длительность в отсчетах таймера; 0 -- нет данных.
+*/
+uint32_t capturePulseWidth(void);
+
+/**
+\brief Частота сигнала.
+\return Частота, Гц; 0 -- нет данных.
+*/
+uint32_t captureFrequency(void);
+
+/**
+\brief Коэффициент заполнения.
+\details Только в режиме CAPTURE_BOTH.
+\return Заполнение в десятых долях процента (0..1000).
+*/
+uint16_t captureDuty(void);
+
+/**
+\brief Перевод отсчетов таймера в микросекунды.
+\param ticks Отсчеты.
+\return Время, мкс; 0 -- захват не запущен (предделитель неизвестен).
+*/
+uint32_t captureTicksToUs(uint32_t ticks);
+
+/**
+\brief Забрать отметки из кольцевого буфера.
+\details Значения ICR (16 бит) в порядке захвата. При переполнении
+буфера старые отметки теряются.
+\param buf Куда копировать.
+\param max Размер buf.
+\return Количество скопированных отметок.
+*/
+uint8_t captureRead(uint16_t *buf, uint8_t max);
+
+#endif /* CAPTURE_H_ */
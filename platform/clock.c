@@ -0,0 +1,112 @@
+/**
+ \file clock.c
+ \author agent <agent@local>
+ \brief Монотонные часы с микросекундным разрешением
+ \details Счетчик таймера 1, расширенный счетчиком переполнений.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+
+#include "timer.h"
+#include "timer_claim.h"
+#include "clock.h"
+
+#if CLOCK_TICKS_PER_US != 1 && CLOCK_TICKS_PER_US != 2
+#error "clock.c expects F_CPU of 8 or 16 MHz"
+#endif
+
+static volatile uint32_t overflows;		//!< Старшие разряды счетчика.
+static uint8_t claimed;					//!< Переполнение таймера 1 занято нами.
+
+TIMER_CLAIM_STATIC(1, OVF)
+
+/**
+\brief Переполнение таймера 1.
+*/
+ISR(TIMER1_OVF_vect)
+{
+	overflows++;
+}
+
+int8_t clockInit(void)
+{
+	int8_t r;
+
+	if (claimed)
+		return 0;
+	r = timerClaim(1, TIMER_OVERFLOW_INT, CLK_DIV_8, NORMAL_MODE, "clock");
+	if (r < 0)
+		return r;
+	claimed = 1;
+	if (r == TIMER_CLAIM_FIRST)
+	{
+		TCCR1A = 0;
+		TCCR1B = 0;
+		TCNT1 = 0;
+	}
+	overflows = 0;
+	TIFR1 = 1 << TOV1;
+	TIMSK1 |= 1 << TOIE1;
+	if (r == TIMER_CLAIM_FIRST)
+		TCCR1B = 1 << CS11;			// Нормальный режим, F_CPU/8.
+	return 0;
+}
+
+/**
+\brief Согласованно читает счетчик и переполнения. Внутренняя функция.
+\details Если переполнение произошло, а прерывание еще не обработано
+(прерывания запрещены), флаг TOV1 уже установлен: учитываем его сами.
+Счетчик при этом сравниваем с половиной диапазона -- флаг, выставленный
+после чтения TCNT1, к прочитанному значению не относится.
+\param cnt Младшие 16 бит.
+\return Старшие разряды.
+*/
+static uint32_t snapshot(uint16_t *cnt)
+{
+	uint8_t sreg = SREG;
+	uint32_t ovf;
+	uint16_t c;
+
+	cli();
+	c = TCNT1;
+	ovf = overflows;
+	if ((TIFR1 & (1 << TOV1)) && (c < 0x8000))
+		ovf++;
+	SREG = sreg;
+	*cnt = c;
+	return ovf;
+}
+
+uint64_t clockTicks(void)
+{
+	uint16_t cnt;
+	uint64_t ovf = snapshot(&cnt);
+
+	return (ovf << 16) | cnt;
+}
+
+uint32_t clockMicros(void)
+{
+	uint16_t cnt;
+	uint32_t ovf = snapshot(&cnt);
+
+#if CLOCK_TICKS_PER_US == 2
+	return (ovf << 15) | (cnt >> 1);
+#else
+	return (ovf << 16) | cnt;
+#endif
+}
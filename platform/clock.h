@@ -0,0 +1,63 @@
+/**
+ \file clock.h
+ \author agent <agent@local>
+ \brief Монотонные часы с микросекундным разрешением
+ \details Таймер 1 считает непрерывно от F_CPU/8 (0,5 мкс при 16 МГц),
+ переполнения считаются в прерывании и расширяют 16-битный счетчик. Чтение
+ не пропускает переполнение, случившееся между чтением счетчика и
+ счетчика переполнений, и может выполняться из прерываний.
+\code{.c}
+	uint32_t t0 = clockMicros();
+	ds18b20_read(&mem);
+	printf("read: %lu us\r\n", clockMicros() - t0);	// верно и при переполнении
+\endcode
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <stdint.h>
+
+/**
+ \brief  Отсчетов часов в микросекунде.
+ */
+#define CLOCK_TICKS_PER_US	(F_CPU / 8000000UL)
+
+/**
+\brief Запуск часов.
+\details Занимает переполнение таймера 1 (нормальный режим, F_CPU/8, см.
+timer_claim.h). Для работы нужны разрешенные прерывания.
+\return 0 -- успешно; меньше нуля -- таймер 1 занят несовместимо (код timerClaim()).
+*/
+int8_t clockInit(void);
+
+/**
+\brief Количество отсчетов с момента запуска.
+\details Значимы младшие 48 бит (16 бит таймера и 32 бита счетчика
+переполнений): счет начинается с нуля раз в 2^48 отсчетов, около 4,4 года
+при F_CPU 16 МГц. Старшие 16 бит всегда нулевые.
+\return Отсчеты (1/CLOCK_TICKS_PER_US мкс).
+*/
+uint64_t clockTicks(void);
+
+/**
+\brief Микросекунды с момента запуска.
+\details Переполняется раз в 71 минуту; разность двух отметок верна
+через переполнение, если интервал короче.
+\return Время, мкс.
+*/
+uint32_t clockMicros(void);
+
+#endif /* CLOCK_H_ */
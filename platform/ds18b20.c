@@ -3,7 +3,8 @@
  \author Shauerman Alexander <shamrel@yandex.ru>  www.labfor.ru
  \brief Библиотека для работы с термодатчиком DS18B20 стенда LESO6.
  \details Библиотека содержит функции для работы с термодатчиком DS18B20.
- Датчик подключен по однопроводному интерфейсу 1-Wire (One Wire Interface -- OWI)
+ Датчик подключен по однопроводному интерфейсу 1-Wire (One Wire Interface -- OWI),
+ работа с шиной -- в owi.c.
  \version   0.1
  \date 4.12.2014
  \copyright
@@ -20,123 +21,356 @@ the source code.
 
 #include <avr/io.h>
 #include <util/delay.h>
+#include <avr/pgmspace.h>
+#include <stddef.h>
 
 #include "ds18b20.h"
 
-#define OWI_PORT 	PORTB
-#define OWI_PIN 	PINB
-#define OWI_DDR 	DDRB
-#define OWI_BIT		(4)
-
-
-#define OWI_CMD_SKIPROM			(0xCC)					//!< Команда для доступа ко всем устройствам на шине сразу.
-
 #define THERM_CMD_CONVERTTEMP 	(0x44)					//!< Команда однократного преобразования температуры.
 #define THERM_CMD_RSCRATCHPAD 	(0xBE)					//!< Команда чтения памяти DS18B20.
 #define THERM_CMD_WSCRATCHPAD 	(0x4E)					//!< Команда записи в память DS18B20.
+#define THERM_CMD_CPYSCRATCHPAD	(0x48)					//!< Команда копирования памяти DS18B20 в EEPROM.
+#define THERM_CMD_RPWRSUPPLY	(0xB4)					//!< Команда проверки питания (паразитное/внешнее).
+
+#define THERM_CFG_RES_SHIFT		(5)						//!< Положение битов R1:R0 в регистре конфигурации.
+
+/**
+ \brief  Таблица CRC8 по полиному X^8+X^5+X^4+X^0 (обратный порядок битов, 0x8C).
+ \details Значение элемента -- контрольная сумма байта с этим номером.
+ Хранится во FLASH, занимает 256 байт.
+ */
+static const uint8_t crc8_table[256] PROGMEM =
+{
+	0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+	0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+	0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+	0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+	0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5, 0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+	0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+	0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+	0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B, 0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+	0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+	0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+	0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C, 0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+	0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+	0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+	0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4, 0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+	0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+	0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35
+};
+
+/**
+ \brief  Шаг расчета контрольной суммы на один байт.
+ */
+#define CRC8_STEP(crc, byte)	pgm_read_byte(&crc8_table[(uint8_t)((crc) ^ (byte))])
+
+/**
+ \brief  Таблица адресов датчиков на шине.
+ */
+static uint8_t ds18b20_table[DS18B20_MAX_DEVICES][OWI_ROM_SIZE];
+static uint8_t ds18b20_devices;						//!< Количество датчиков в таблице.
+
+/**
+ \brief  Разрешение каждого датчика из таблицы (регистр конфигурации).
+ */
+static uint8_t ds18b20_res[DS18B20_MAX_DEVICES];
+static uint8_t ds18b20_res_all = DS18B20_RES_12BIT;	//!< Разрешение, записанное без адреса.
+
+/**
+ \brief  Состояние преобразования.
+ */
+#define CONV_IDLE		(0)		//!< Преобразование не запускалось или завершено.
+#define CONV_POLL		(1)		//!< Идет преобразование, готовность можно опрашивать.
+#define CONV_BLIND		(2)		//!< Идет преобразование, опрос невозможен.
 
-#define OWN_HIGH()		{ OWI_DDR &= ~(1<<OWI_BIT);}	//!< Отпускаем линию. Конфигурируем ее на ввод.
-#define OWN_LOW()		{ OWI_DDR |= (1<<OWI_BIT);}		//!< Устанавливаем ноль. Конфигурируем ее на вывод.
+#define POWER_UNKNOWN	(0)		//!< Тип питания датчиков еще не проверялся.
+#define POWER_EXTERNAL	(1)		//!< Все датчики с внешним питанием.
+#define POWER_PARASITE	(2)		//!< Есть датчики с паразитным питанием.
 
-void OWI_write_bit(uint8_t bit)
+static uint8_t ds18b20_conv_state = CONV_IDLE;
+static uint8_t ds18b20_conv_dev;						//!< Датчик, на котором запущено преобразование.
+static uint8_t ds18b20_power = POWER_UNKNOWN;
+
+/**
+\brief Шина занята другой командой.
+\details Вызывается перед любой командой ROM, кроме ожидаемого запуска
+преобразования: после нее слоты чтения уже не показывают готовность.
+*/
+static void ds18b20_bus_used(void)
 {
-	// инициализируем таймслот
-	OWN_LOW();						// Удерживаем шину в нуле 1 мкс.
-	_delay_us(2);
-	if(bit) OWN_HIGH(); 			// Если требуется передать "1", то отпускаем шину.
-	_delay_us(60);					// Ждем пока приемник воспримет бит.
-	OWN_HIGH(); 					// Отпускаем шину.
-	_delay_us(2);
+	if(ds18b20_conv_state == CONV_POLL)
+		ds18b20_conv_state = CONV_BLIND;
 }
 
-uint8_t OWI_read_bit(void)
+uint8_t ds18b20_search(void)
 {
-	uint8_t bit;
-	// инициализируем таймслот
-	OWN_LOW();							// Удерживаем шину в нуле 1 мкс.
-	_delay_us(1);
-	OWN_HIGH();							// Отпускаем шину.
-	_delay_us(15);
-	bit = OWI_PIN&(1<<OWI_BIT) ? 1:0;	// Читаем состояние шины.
-	_delay_us(45);						// Дожидаемся конца таймслота.
-	return bit;
+	uint8_t rom[OWI_ROM_SIZE];
+	uint8_t last = 0, i;
+
+	ds18b20_devices = 0;
+	ds18b20_bus_used();
+	do
+	{
+		last = OWI_search(OWI_CMD_SEARCHROM, rom, last);
+		if(last == OWI_SEARCH_ERROR) break;
+		// Отбрасываем адреса с ошибкой и устройства других семейств.
+		if(ds18b20_crc8(rom, OWI_ROM_SIZE) || (rom[0] != DS18B20_FAMILY_CODE)) continue;
+		for(i=0; i<OWI_ROM_SIZE; i++)
+			ds18b20_table[ds18b20_devices][i] = rom[i];
+		ds18b20_res[ds18b20_devices] = DS18B20_RES_12BIT;	// Пока не известно, считаем худший случай.
+		ds18b20_devices++;
+	} while(last && (ds18b20_devices < DS18B20_MAX_DEVICES));
+
+	return ds18b20_devices;
 }
 
-void OWI_write_byte(uint8_t byte)
+uint8_t ds18b20_alarm_search(uint8_t *devs, uint8_t max)
 {
-	uint8_t i;
-	for(i=0; i<8; i++) OWI_write_bit(byte&(1 << i));
+	uint8_t rom[OWI_ROM_SIZE];
+	uint8_t last = 0, found = 0, dev, i;
+
+	ds18b20_bus_used();
+	while(found < max)
+	{
+		// Отвечают только датчики, у которых последнее измерение вышло за пороги.
+		last = OWI_search(OWI_CMD_ALARMSEARCH, rom, last);
+		if(last == OWI_SEARCH_ERROR) break;	// Никто не ответил -- тревоги нет.
+		if(!ds18b20_crc8(rom, OWI_ROM_SIZE))
+		{
+			for(dev=0; dev<ds18b20_devices; dev++)	// Ищем датчик в таблице.
+			{
+				for(i=0; i<OWI_ROM_SIZE; i++)
+					if(ds18b20_table[dev][i] != rom[i]) break;
+				if(i == OWI_ROM_SIZE)
+				{
+					devs[found++] = dev;
+					break;
+				}
+			}
+		}
+		if(!last) break;					// Это было последнее устройство.
+	}
+	return found;
 }
 
-uint8_t OWI_read_byte(void)
+uint8_t ds18b20_count(void)
 {
-	uint8_t i, byte = 0;
+	return ds18b20_devices;
+}
 
-	for(i=0; i<8; i++)	byte |=  OWI_read_bit() << i;
+const uint8_t *ds18b20_rom(uint8_t dev)
+{
+	if(dev >= ds18b20_devices) return NULL;
+	return ds18b20_table[dev];
+}
 
-	return byte;
+uint8_t ds18b20_presence(void)
+{
+	ds18b20_bus_used();
+	return OWI_presence();
 }
 
 /**
-\brief Процедура инициализации -- сброс и проверка наличия устройства.
-\return  1 -- на шине есть устройство;
-\return  0 -- на шине нет устройства;
+\brief Сброс шины и выбор датчика.
+\param dev Номер датчика в таблице, либо DS18B20_ALL.
+\return  0 -- датчик выбран, можно передавать команду;
+\return -1 -- устройство не отвечает;
+\return -2 -- нет датчика с таким номером.
 */
-uint8_t OWI_presence(void)
+static int8_t ds18b20_select(uint8_t dev)
 {
-	uint8_t	status;
-
-	status = OWI_PIN&(1<<OWI_BIT) ? 1:0;	// Читаем состояние шины.
-	if(!status) return status;				// Если на шине уже был ноль, значит либо сбой,
-											// либо преобразование еще не завершено.
-	OWI_PORT &= ~(1<<OWI_BIT);				// Записываем в регистр вывода ноль.
-	OWN_LOW();								// Устанавливаем ноль на линии.
-	_delay_us(480);
-	OWN_HIGH();								// Отпускаем шину.
-	_delay_us(60);							// Ждем пока устроство ответит.
-	status = OWI_PIN&(1<<OWI_BIT) ? 0:1;	// Читаем состояние шины.
-	_delay_us(420);
+	uint8_t i;
 
-	return status;
+	if((dev != DS18B20_ALL) && (dev >= ds18b20_devices)) return (-2);
+	ds18b20_bus_used();
+	if(!OWI_presence()) return (-1);		// Устройство не ответило.
+	if(dev == DS18B20_ALL)
+	{
+		OWI_write_byte(OWI_CMD_SKIPROM);	// Обращаемся ко всем устройствам на шине сразу.
+		return 0;
+	}
+	OWI_write_byte(OWI_CMD_MATCHROM);		// Обращаемся к устройству по адресу.
+	for(i=0; i<OWI_ROM_SIZE; i++)
+		OWI_write_byte(ds18b20_table[dev][i]);
+	return 0;
 }
 
 int8_t ds18b20_convert()
 {
-	if(!OWI_presence()) return (-1);		// Устройство не ответило.
-	OWI_write_byte(OWI_CMD_SKIPROM);		// Обращаемся ко всем устройствам на шине сразу.
+	return ds18b20_convert_dev(DS18B20_ALL);
+}
+
+int8_t ds18b20_convert_dev(uint8_t dev)
+{
+	int8_t status;
+
+	if(ds18b20_power == POWER_UNKNOWN)		// Проверяем питание один раз.
+	{
+		status = ds18b20_select(DS18B20_ALL);
+		if(status) return status;
+		OWI_write_byte(THERM_CMD_RPWRSUPPLY);
+		// Датчик с паразитным питанием отвечает нулем.
+		ds18b20_power = OWI_read_bit() ? POWER_EXTERNAL : POWER_PARASITE;
+	}
+
+	status = ds18b20_select(dev);
+	if(status) return status;
 	OWI_write_byte(THERM_CMD_CONVERTTEMP);	// Команда на запуск преобразования.
+	// При внешнем питании датчик отвечает нулем на слот чтения, пока идет
+	// преобразование. При паразитном питании ответить он не может.
+	ds18b20_conv_state = (ds18b20_power == POWER_EXTERNAL) ? CONV_POLL : CONV_BLIND;
+	ds18b20_conv_dev = dev;
 	return 0;
 }
 
+int8_t ds18b20_ready(void)
+{
+	switch(ds18b20_conv_state)
+	{
+	case CONV_POLL:
+		if(!OWI_read_bit()) return 0;		// Преобразование еще идет.
+		ds18b20_conv_state = CONV_IDLE;
+		return 1;
+	case CONV_BLIND:
+		return (-1);
+	default:
+		return 1;
+	}
+}
+
+void ds18b20_wait(void)
+{
+	uint16_t ms;
+	int8_t ready;
+
+	ms = ds18b20_conv_time(ds18b20_conv_dev);
+	while(ms--)
+	{
+		ready = ds18b20_ready();
+		if(ready > 0) return;
+		_delay_ms(1);
+	}
+	ds18b20_conv_state = CONV_IDLE;		// Время преобразования истекло.
+}
+
 int8_t ds18b20_read(ds18b20_memory_t *memory)
+{
+	return ds18b20_read_dev(DS18B20_ALL, memory);
+}
+
+int8_t ds18b20_read_dev(uint8_t dev, ds18b20_memory_t *memory)
 {
 	uint8_t *scrathpad;
-	uint8_t i;
+	uint8_t i, crc = 0;
+	int8_t status;
 
-	if(!OWI_presence()) return (-1);		// Устройство не ответило.
-	OWI_write_byte(OWI_CMD_SKIPROM);		// Обращаемся ко всем устройствам на шине сразу.
+	status = ds18b20_select(dev);
+	if(status) return status;
 	OWI_write_byte(THERM_CMD_RSCRATCHPAD);	// Команда на чтение памяти.
 
 	scrathpad = (uint8_t *) memory;			// Устанавливаем указатель на начало структуры
 	for(i=0; i<sizeof(ds18b20_memory_t); i++)
+	{
 		scrathpad[i] = OWI_read_byte();		// Считываем побайтно память.
+		crc = CRC8_STEP(crc, scrathpad[i]);	// Считаем CRC, пока идет следующий байт.
+	}
+	return crc ? (-3) : 0;					// С учетом байта CRC сумма должна быть 0.
+}
+
+int8_t ds18b20_read_temp(uint8_t dev, int16_t *temper)
+{
+	uint8_t lsb, msb, i, crc;
+	int8_t status;
+
+	status = ds18b20_select(dev);
+	if(status) return status;
+	OWI_write_byte(THERM_CMD_RSCRATCHPAD);	// Команда на чтение памяти.
+	lsb = OWI_read_byte();
+	msb = OWI_read_byte();					// Остальное не читаем, чтение прервет
+											// сброс перед следующей командой.
+	if((lsb == 0xFF) && (msb == 0xFF))
+	{
+		// Это -0,0625 °C или линия в единице (датчик не ответил). Различаем
+		// по контрольной сумме: у памяти из одних 0xFF она не сходится.
+		crc = CRC8_STEP(CRC8_STEP(0, lsb), msb);
+		for(i=2; i<sizeof(ds18b20_memory_t); i++)
+			crc = CRC8_STEP(crc, OWI_read_byte());
+		if(crc) return (-1);
+	}
+	*temper = (int16_t)((msb << 8) | lsb);
 	return 0;
 }
 
-#define CRC8_POLY    0x18              ///!< Образующий полином: 0X18 = X^8+X^5+X^4+X^0
+int8_t ds18b20_config(uint8_t dev, int8_t th, int8_t tl, ds18b20_res_t res, uint8_t save)
+{
+	int8_t status;
+	uint8_t i;
 
-uint8_t ds18b20_crc8( uint8_t *data, uint8_t len )
+	status = ds18b20_select(dev);
+	if(status) return status;
+	OWI_write_byte(THERM_CMD_WSCRATCHPAD);	// Команда на запись памяти.
+	OWI_write_byte((uint8_t)th);
+	OWI_write_byte((uint8_t)tl);
+	OWI_write_byte(res);
+
+	if(dev == DS18B20_ALL)
+	{
+		ds18b20_res_all = res;
+		for(i=0; i<ds18b20_devices; i++) ds18b20_res[i] = res;
+	}
+	else ds18b20_res[dev] = res;
+
+	if(!save) return 0;
+	status = ds18b20_select(dev);
+	if(status) return status;
+	OWI_write_byte(THERM_CMD_CPYSCRATCHPAD);	// Копируем Th, Tl и конфигурацию в EEPROM.
+	_delay_ms(10);							// Ждем окончания записи EEPROM.
+	return 0;
+}
+
+int8_t ds18b20_set_alarm(uint8_t dev, int8_t th, int8_t tl)
 {
-	uint8_t  crc = 0, i, byte;
+	uint8_t i;
+	int8_t status;
 
-	while (len--)
+	// Th, Tl и конфигурация пишутся только вместе, разрешение оставляем прежним.
+	if(dev != DS18B20_ALL)
 	{
-		byte = *data++;
-		for (i = 0; i < 8; i++)
-		{
-			crc = ((crc ^ byte)&1)? ((crc^CRC8_POLY)>>1)|0x80 : (crc>>1);
-			byte >>= 1;
-		}
+		if(dev >= ds18b20_devices) return (-2);
+		return ds18b20_config(dev, th, tl, ds18b20_res[dev], 0);
+	}
+	if(!ds18b20_devices)					// Поиск не выполнялся: разрешение общее.
+		return ds18b20_config(DS18B20_ALL, th, tl, ds18b20_res_all, 0);
+	for(i=0; i<ds18b20_devices; i++)		// У датчиков может быть разное разрешение.
+	{
+		status = ds18b20_config(i, th, tl, ds18b20_res[i], 0);
+		if(status) return status;
 	}
+	return 0;
+}
+
+uint16_t ds18b20_conv_time(uint8_t dev)
+{
+	uint8_t res, i;
+
+	if(dev != DS18B20_ALL) res = (dev < ds18b20_devices) ? ds18b20_res[dev] : DS18B20_RES_12BIT;
+	else if(!ds18b20_devices) res = ds18b20_res_all;	// Поиск не выполнялся, датчик один.
+	else
+	{
+		res = DS18B20_RES_9BIT;
+		for(i=0; i<ds18b20_devices; i++)
+			if(ds18b20_res[i] > res) res = ds18b20_res[i];
+	}
+	// Каждый бит разрешения удваивает время преобразования.
+	res = 3 - ((res >> THERM_CFG_RES_SHIFT) & 0x03);
+	return (DS18B20_TCONV_MS + (1 << res) - 1) >> res;
+}
+
+uint8_t ds18b20_crc8( uint8_t *data, uint8_t len )
+{
+	uint8_t  crc = 0;
+
+	while (len--)
+		crc = CRC8_STEP(crc, *data++);
 	return crc;
 }
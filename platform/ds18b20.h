@@ -23,6 +23,49 @@ the source code.
 
 
 #include <stdint.h>
+#include "owi.h"
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Максимальное количество датчиков на шине.
+ \details Определяет размер таблицы адресов, заполняемой ds18b20_search().
+ Каждый датчик занимает в ОЗУ 8 байт.
+ */
+#define DS18B20_MAX_DEVICES		(16)
+/*************************************************************************/
+
+/**
+ \brief  Номер устройства для широковещательного обращения (SKIP ROM).
+ \details Используется вместо номера датчика, когда на шине один датчик,
+ либо команду нужно отправить всем датчикам сразу.
+ */
+#define DS18B20_ALL				(0xFF)
+
+/**
+ \brief  Код семейства DS18B20 (первый байт ROM).
+ */
+#define DS18B20_FAMILY_CODE		(0x28)
+
+/**
+ \brief  Время преобразования при разрешении 12 бит, мс.
+ \details При уменьшении разрешения на каждый бит время сокращается вдвое.
+ */
+#define DS18B20_TCONV_MS		(750)
+
+/**
+ \brief Разрешение датчика (значение регистра конфигурации).
+ */
+typedef enum ds18b20_res
+{
+	DS18B20_RES_9BIT = 0x1F,	//!< 0,5 °C, 93,75 мс
+	DS18B20_RES_10BIT = 0x3F,	//!< 0,25 °C, 187,5 мс
+	DS18B20_RES_11BIT = 0x5F,	//!< 0,125 °C, 375 мс
+	DS18B20_RES_12BIT = 0x7F	//!< 0,0625 °C, 750 мс (по умолчанию)
+} ds18b20_res_t;
 
 /**
  \struct ds18b20_memory_
@@ -46,29 +89,183 @@ ds18b20_memory_t;
 \brief Процедура инициализации -- сброс и проверка наличия устройства.
 \return  1 -- на шине есть устройство;
 \return  0 -- на шине нет устройства;
+\note Сброс прерывает опрос готовности (см. ds18b20_ready()).
 */
-#define ds18b20_presence() OWI_presence();
+uint8_t ds18b20_presence(void);
+
+/**
+ \brief Поиск датчиков на шине (алгоритм SEARCH ROM).
+ \details Перебирает все устройства на шине и заносит адреса датчиков
+ DS18B20 в таблицу. Адреса с ошибкой контрольной суммы и устройства
+ других семейств пропускаются. Номер датчика в таблице (от 0) затем
+ используется в функциях ds18b20_xxx_dev().
+ Поиск занимает около 15 мс на каждый датчик, поэтому вызывать
+ его следует при старте или при изменении состава шины.
+ \return Количество найденных датчиков (не более DS18B20_MAX_DEVICES).
+*/
+uint8_t ds18b20_search(void);
+
+/**
+ \brief Количество датчиков в таблице.
+ \return Количество датчиков, найденных последним вызовом ds18b20_search().
+*/
+uint8_t ds18b20_count(void);
+
+/**
+ \brief Адрес датчика.
+ \param dev Номер датчика в таблице.
+ \return Указатель на 8 байт ROM датчика; NULL -- нет такого датчика.
+*/
+const uint8_t *ds18b20_rom(uint8_t dev);
 
 /**
  \brief Функция запускает преобразование (измерение температуры).
+ \details Команда отправляется всем датчикам на шине сразу (SKIP ROM),
+ поэтому все датчики измеряют температуру одновременно, за одно время
+ преобразования. После этого результаты читаются по одному
+ функцией ds18b20_read_dev().
  \return  0 -- преобразование запущено успешно;
  \return -1 -- устройство не отвечает.
 */
 int8_t ds18b20_convert();
 
+/**
+ \brief Проверяет, завершено ли преобразование.
+ \details Выдает на шину один слот чтения (около 60 мкс): пока датчик с
+ внешним питанием преобразует температуру, он отвечает нулем. Функцию можно
+ вызывать в цикле или из прерывания таймера и читать результат сразу по
+ готовности, не дожидаясь худшего времени преобразования.
+ Опрос возможен, только если после ds18b20_convert() на шине не было других
+ команд и у всех датчиков внешнее питание (проверяется при первом запуске
+ преобразования).
+ \return  1 -- преобразование завершено (или не запускалось);
+ \return  0 -- преобразование еще идет;
+ \return -1 -- готовность опросить нельзя, ждать нужно ds18b20_conv_time() мс.
+*/
+int8_t ds18b20_ready(void);
+
+/**
+ \brief Ждет окончания последнего запущенного преобразования.
+ \details Опрашивает готовность раз в миллисекунду и возвращается, как только
+ данные готовы. Если опрос невозможен, ждет время преобразования с учетом
+ разрешения.
+*/
+void ds18b20_wait(void);
+
+/**
+ \brief Запускает преобразование на одном датчике.
+ \param dev Номер датчика в таблице, либо DS18B20_ALL.
+ \return  0 -- преобразование запущено успешно;
+ \return -1 -- устройство не отвечает;
+ \return -2 -- нет датчика с таким номером.
+*/
+int8_t ds18b20_convert_dev(uint8_t dev);
+
 /**
  \brief Читаем память DS18b20 (SCRATCHPAD).
+ \details Обращение без адреса (SKIP ROM), допустимо только когда на шине
+ один датчик.
  \param *memory Указатель на структуру, описывающую карту памяти DS18B20
- \return  0 -- преобразование запущено успешно;
- \return -1 -- устройство не отвечает.
+ \return  0 -- память прочитана, контрольная сумма верна;
+ \return -1 -- устройство не отвечает;
+ \return -3 -- ошибка контрольной суммы.
 */
 int8_t ds18b20_read(ds18b20_memory_t *memory);
 
+/**
+ \brief Читаем память (SCRATCHPAD) датчика по его номеру (MATCH ROM).
+ \details Читает все 9 байт (около 4,4 мс на шине) и по ходу чтения считает
+ контрольную сумму: табличный шаг CRC занимает около 10 тактов на байт и
+ выполняется между слотами чтения, так что отдельный вызов ds18b20_crc8()
+ не нужен.
+ \param dev Номер датчика в таблице, либо DS18B20_ALL.
+ \param *memory Указатель на структуру, описывающую карту памяти DS18B20
+ \return  0 -- память прочитана, контрольная сумма верна;
+ \return -1 -- устройство не отвечает;
+ \return -2 -- нет датчика с таким номером;
+ \return -3 -- ошибка контрольной суммы.
+*/
+int8_t ds18b20_read_dev(uint8_t dev, ds18b20_memory_t *memory);
+
+/**
+ \brief Быстрое чтение температуры.
+ \details Читает только 2 байта температуры (около 1 мс на шине вместо 4,4 мс),
+ остальная память не передается. Контрольная сумма при этом не проверяется,
+ поэтому режим подходит, когда достоверность контролируется иначе, например
+ сравнением с предыдущими показаниями. Только при коде 0xFFFF (-0,0625 °C),
+ который совпадает с молчащей линией, дочитывается вся память и проверяется
+ контрольная сумма.
+ \param dev Номер датчика в таблице, либо DS18B20_ALL.
+ \param *temper Температура в единицах 1/16 °C.
+ \return  0 -- температура прочитана;
+ \return -1 -- устройство не отвечает;
+ \return -2 -- нет датчика с таким номером.
+*/
+int8_t ds18b20_read_temp(uint8_t dev, int16_t *temper);
+
+/**
+ \brief Записывает в датчик пороги тревоги и разрешение.
+ \details Записывает в SCRATCHPAD байты Th, Tl и регистр конфигурации.
+ Запомненное разрешение используется в ds18b20_conv_time().
+ \param dev Номер датчика в таблице, либо DS18B20_ALL.
+ \param th Верхний порог тревоги, °C.
+ \param tl Нижний порог тревоги, °C.
+ \param res Разрешение.
+ \param save 1 -- скопировать настройки в EEPROM датчика (сохраняются после
+ отключения питания), 0 -- только в SCRATCHPAD. Копирование занимает 10 мс.
+ \return  0 -- настройки записаны;
+ \return -1 -- устройство не отвечает;
+ \return -2 -- нет датчика с таким номером.
+*/
+int8_t ds18b20_config(uint8_t dev, int8_t th, int8_t tl, ds18b20_res_t res, uint8_t save);
+
+/**
+ \brief Задает пороги тревоги датчика.
+ \details Записывает Th и Tl, сохраняя разрешение, известное драйверу
+ (заданное через ds18b20_config(), по умолчанию 12 бит). После каждого
+ преобразования датчик сравнивает целую часть температуры с порогами:
+ при T >= Th или T <= Tl он отвечает на ds18b20_alarm_search().
+ DS18B20_ALL после ds18b20_search() записывает датчики по одному (MATCH ROM),
+ каждому -- его собственное разрешение.
+ \param dev Номер датчика в таблице, либо DS18B20_ALL.
+ \param th Верхний порог тревоги, °C.
+ \param tl Нижний порог тревоги, °C.
+ \return  0 -- пороги записаны;
+ \return -1 -- устройство не отвечает;
+ \return -2 -- нет датчика с таким номером.
+*/
+int8_t ds18b20_set_alarm(uint8_t dev, int8_t th, int8_t tl);
+
+/**
+ \brief Поиск датчиков в состоянии тревоги (ALARM SEARCH).
+ \details Вызывается после завершения широковещательного ds18b20_convert().
+ Возвращает только датчики, вышедшие за пороги, поэтому при нормальной
+ температуре на всех датчиках цикл опроса стоит одного сброса шины и
+ двух слотов чтения вместо чтения памяти каждого датчика.
+ \param *devs Массив для номеров датчиков (в таблице ds18b20_search()).
+ \param max Размер массива.
+ \return Количество датчиков в состоянии тревоги.
+*/
+uint8_t ds18b20_alarm_search(uint8_t *devs, uint8_t max);
+
+/**
+ \brief Время преобразования с учетом разрешения.
+ \details Для DS18B20_ALL возвращает время самого медленного датчика, т.е.
+ время, через которое готовы результаты широковещательного ds18b20_convert().
+ Пока разрешение датчика не задано через ds18b20_config(), считается, что
+ оно 12 бит.
+ \param dev Номер датчика в таблице, либо DS18B20_ALL.
+ \return Время преобразования, мс.
+*/
+uint16_t ds18b20_conv_time(uint8_t dev);
+
 /**
  \brief Вычисляет контрольную сумм по полигону X^8+X^5+X^4+X^0
  \note Если последний байт входных данных равен контрольной сумме по
   всем предыдущим, то функция вернет 0.
- \note Расчет требует много процессорного времени.
+ \note Расчет табличный (таблица 256 байт во FLASH): около 10 тактов на байт
+ против 100-110 тактов побитового расчета, т.е. около 90 тактов вместо
+ 950 на всю память датчика.
  \param *data Указатель на байтовый массив данных.
  \param len Длинна массива.
  \return  Контрольная сумма.
@@ -0,0 +1,294 @@
+/**
+ \file keypad.c
+ \author agent <agent@local>
+ \brief Матричная клавиатура 4x3 стенда LESO6
+ \details Сканирование по программному таймеру, автомат подавления дребезга
+ на каждую клавишу, очередь событий.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "swtimer.h"
+#include "keypad.h"
+
+/**
+ \brief  Выводы клавиатуры.
+ */
+#define COLUMNS		PORTG			//!< Столбцы: PG0..PG2.
+#define COLUMNS_DDR	DDRG
+#define COL_MASK	0x07
+#define ROWS_PIN	PIND			//!< Строки: PD4..PD7.
+#define ROWS_PORT	PORTD
+#define ROWS_DDR	DDRD
+#define ROW_SHIFT	4
+#define ROW_MASK	0xF0
+
+#define DEBOUNCE_SCANS	(KEYPAD_DEBOUNCE_MS / KEYPAD_SCAN_MS)
+#define LONG_SCANS		(KEYPAD_LONG_MS / KEYPAD_SCAN_MS)
+#define REPEAT_SCANS	(KEYPAD_REPEAT_MS / KEYPAD_SCAN_MS)
+#define QUEUE_MASK		(KEYPAD_QUEUE_SIZE - 1)
+
+/**
+ \brief  Состояния автомата клавиши.
+ */
+enum
+{
+	KEY_UP = 0,			//!< Отпущена
+	KEY_DOWN_WAIT,		//!< Замкнута, ждем окончания дребезга
+	KEY_DOWN,			//!< Нажата
+	KEY_HELD,			//!< Удерживается, идет автоповтор
+	KEY_UP_WAIT			//!< Разомкнута, ждем окончания дребезга
+};
+
+static const char keyChars[KEYPAD_KEYS] PROGMEM =
+{	'1', '2', '3',
+	'4', '5', '6',
+	'7', '8', '9',
+	'*', '0', '#' };
+
+static uint8_t state[KEYPAD_KEYS];
+static uint8_t counter[KEYPAD_KEYS];		//!< Сканов в текущем состоянии.
+static uint8_t last_state[KEYPAD_KEYS];		//!< Состояние до дребезга отпускания.
+
+static keypad_event_t queue[KEYPAD_QUEUE_SIZE];
+static volatile uint8_t queue_wr, queue_rd;
+static volatile uint8_t lost;
+static uint16_t now;						//!< Время, мс.
+static uint8_t raw[KEYPAD_COLS];			//!< Последний однозначный скан.
+static volatile uint16_t pressed;			//!< Нажатые клавиши после подавления дребезга.
+static volatile uint8_t ghost;				//!< Последний скан неоднозначен.
+
+static void scanCb(void *arg);
+static swtimer_t scan_timer = SWTIMER_INIT(scanCb, NULL);
+
+/**
+\brief Опрос матрицы. Внутренняя функция.
+\details На каждый столбец -- одна запись в порт и одно чтение всех строк.
+Результат -- по тетраде строк на столбец, без перебора битов.
+\param cols Замкнутые строки по столбцам (бит row).
+*/
+static void scanMatrix(uint8_t cols[KEYPAD_COLS])
+{
+	COLUMNS = (COLUMNS | COL_MASK) & ~(1 << 0);
+	__asm__ __volatile__ ("nop\n\tnop");		// Синхронизатор порта: 1,5 такта.
+	cols[0] = (uint8_t)(~ROWS_PIN & ROW_MASK) >> ROW_SHIFT;
+	COLUMNS = (COLUMNS | COL_MASK) & ~(1 << 1);
+	__asm__ __volatile__ ("nop\n\tnop");
+	cols[1] = (uint8_t)(~ROWS_PIN & ROW_MASK) >> ROW_SHIFT;
+	COLUMNS = (COLUMNS | COL_MASK) & ~(1 << 2);
+	__asm__ __volatile__ ("nop\n\tnop");
+	cols[2] = (uint8_t)(~ROWS_PIN & ROW_MASK) >> ROW_SHIFT;
+	COLUMNS |= COL_MASK;
+}
+
+/**
+\brief Проверка на фантомные нажатия. Внутренняя функция.
+\details В матрице без диодов три нажатые клавиши в углах прямоугольника
+замыкают и четвертую. Такое возможно, только если в двух столбцах замкнуты
+две или больше одинаковых строк; какая из четырех клавиш нажата на самом
+деле, тогда определить нельзя.
+\return 1 -- скан неоднозначен.
+*/
+static uint8_t isGhost(const uint8_t cols[KEYPAD_COLS])
+{
+	uint8_t common;
+
+	common = cols[0] & cols[1];
+	if (common & (common - 1))		// Больше одного бита.
+		return 1;
+	common = cols[0] & cols[2];
+	if (common & (common - 1))
+		return 1;
+	common = cols[1] & cols[2];
+	if (common & (common - 1))
+		return 1;
+	return 0;
+}
+
+/**
+\brief Событие в очередь. Внутренняя функция.
+*/
+static void pushEvent(uint8_t key, uint8_t type)
+{
+	uint8_t next = (queue_wr + 1) & QUEUE_MASK;
+
+	if (next == queue_rd)
+	{
+		if (lost != 0xFF)
+			lost++;
+		return;
+	}
+	queue[queue_wr].key = key;
+	queue[queue_wr].type = type;
+	queue[queue_wr].time = now;
+	queue_wr = next;
+}
+
+/**
+\brief Скан клавиатуры: вызывается программным таймером в прерывании.
+*/
+static void scanCb(void *arg)
+{
+	uint8_t cols[KEYPAD_COLS];
+	uint8_t key, row, column, down;
+
+	now += KEYPAD_SCAN_MS;
+	scanMatrix(cols);
+	ghost = isGhost(cols);
+	if (!ghost)						// Неоднозначный скан не меняет состояние клавиш.
+	{
+		raw[0] = cols[0];
+		raw[1] = cols[1];
+		raw[2] = cols[2];
+	}
+
+	for (key = 0, row = 0, column = 0; key < KEYPAD_KEYS; key++)
+	{
+		down = raw[column] & (1 << row);
+		if (++column == KEYPAD_COLS)
+		{
+			column = 0;
+			row++;
+		}
+		if (counter[key] != 0xFF)
+			counter[key]++;
+
+		switch (state[key])
+		{
+		case KEY_UP:
+			if (down)
+			{
+				state[key] = KEY_DOWN_WAIT;
+				counter[key] = 0;
+			}
+			break;
+		case KEY_DOWN_WAIT:
+			if (!down)
+				state[key] = KEY_UP;			// Короткая помеха.
+			else if (counter[key] >= DEBOUNCE_SCANS)
+			{
+				state[key] = KEY_DOWN;
+				counter[key] = 0;
+				pressed |= 1 << key;
+				pushEvent(key, KEYPAD_PRESS);
+			}
+			break;
+		case KEY_DOWN:
+		case KEY_HELD:
+			if (!down)
+			{
+				last_state[key] = state[key];
+				state[key] = KEY_UP_WAIT;
+				counter[key] = 0;
+			}
+			else if ((state[key] == KEY_DOWN) && (counter[key] >= LONG_SCANS))
+			{
+				state[key] = KEY_HELD;
+				counter[key] = 0;
+				pushEvent(key, KEYPAD_LONG);
+			}
+			else if ((state[key] == KEY_HELD) && (counter[key] >= REPEAT_SCANS))
+			{
+				counter[key] = 0;
+				pushEvent(key, KEYPAD_REPEAT);
+			}
+			break;
+		case KEY_UP_WAIT:
+			if (down)
+			{
+				state[key] = last_state[key];	// Дребезг -- клавиша по-прежнему нажата.
+				counter[key] = 0;
+			}
+			else if (counter[key] >= DEBOUNCE_SCANS)
+			{
+				state[key] = KEY_UP;
+				pressed &= ~(1 << key);
+				pushEvent(key, KEYPAD_RELEASE);
+			}
+			break;
+		}
+	}
+}
+
+void keypadInit(void)
+{
+	uint8_t key;
+
+	COLUMNS_DDR |= COL_MASK;			// Столбцы на вывод,
+	COLUMNS |= COL_MASK;				// все неактивны.
+	ROWS_DDR &= ~ROW_MASK;				// Строки на ввод
+	ROWS_PORT |= ROW_MASK;				// с подтяжкой.
+
+	for (key = 0; key < KEYPAD_KEYS; key++)
+		state[key] = KEY_UP;
+	raw[0] = raw[1] = raw[2] = 0;
+	pressed = 0;
+	ghost = 0;
+	queue_wr = queue_rd = 0;
+	lost = 0;
+	swtimerStart(&scan_timer, KEYPAD_SCAN_MS, KEYPAD_SCAN_MS);
+}
+
+uint8_t keypadGetEvent(keypad_event_t *ev)
+{
+	uint8_t sreg = SREG;
+
+	if (queue_rd == queue_wr)
+		return 0;
+	cli();
+	*ev = queue[queue_rd];
+	queue_rd = (queue_rd + 1) & QUEUE_MASK;
+	SREG = sreg;
+	return 1;
+}
+
+uint8_t keypadLost(void)
+{
+	uint8_t sreg = SREG;
+	uint8_t n;
+
+	cli();
+	n = lost;
+	lost = 0;
+	SREG = sreg;
+	return n;
+}
+
+char keypadChar(uint8_t key)
+{
+	if (key >= KEYPAD_KEYS)
+		return '\n';
+	return pgm_read_byte(&keyChars[key]);
+}
+
+uint16_t keypadState(void)
+{
+	uint8_t sreg = SREG;
+	uint16_t map;
+
+	cli();
+	map = pressed;
+	SREG = sreg;
+	return map;
+}
+
+uint8_t keypadGhost(void)
+{
+	return ghost;
+}
@@ -0,0 +1,143 @@
+/**
+ \file keypad.h
+ \author agent <agent@local>
+ \brief Матричная клавиатура 4x3 стенда LESO6
+ \details Столбцы клавиатуры подключены к PG0..PG2 (выходы), строки -- к
+ PD4..PD7 (входы с подтяжкой). Клавиатура сканируется каждые
+ KEYPAD_SCAN_MS мс периодическим программным таймером (swtimer.h); у каждой
+ клавиши свой автомат подавления дребезга. События (нажатие, отпускание,
+ долгое нажатие, автоповтор) с отметкой времени складываются в очередь,
+ поэтому нажатия не теряются, пока основная программа занята.
+ Сканирование занимает несколько микросекунд.
+
+ Опрашивается вся матрица, поэтому одновременные нажатия (аккорды) не
+ теряются: keypadState() возвращает карту всех нажатых клавиш. Скан, в
+ котором возможно фантомное нажатие (три клавиши в углах прямоугольника),
+ отбрасывается -- состояние клавиш не меняется, пока он не станет однозначным.
+
+ Номер клавиши -- row * 3 + column (0..11): '1', '2', '3', '4', ... '*', '0', '#'.
+\code{.c}
+	keypad_event_t ev;
+
+	swtimerInit();
+	keypadInit();
+	sei();
+	while (1)
+	{
+		if (keypadGetEvent(&ev) && (ev.type == KEYPAD_PRESS))
+			putchar(keypadChar(ev.key));
+	}
+\endcode
+ \note Строки PD4..PD7 не имеют прерываний по изменению уровня (INT4..7 --
+ на порту E), поэтому пробуждение по нажатию не поддерживается.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef KEYPAD_H_
+#define KEYPAD_H_
+
+#include <stdint.h>
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+#define KEYPAD_SCAN_MS		(5)		//!< Период сканирования, мс.
+#define KEYPAD_DEBOUNCE_MS	(20)	//!< Время устойчивого состояния для смены нажата/отпущена, мс.
+#define KEYPAD_LONG_MS		(800)	//!< Нажатие дольше -- долгое, начинается автоповтор, мс.
+#define KEYPAD_REPEAT_MS	(150)	//!< Период автоповтора, мс.
+#define KEYPAD_QUEUE_SIZE	(16)	//!< Размер очереди событий (степень двойки).
+/*************************************************************************/
+
+#define KEYPAD_ROWS			(4)
+#define KEYPAD_COLS			(3)
+#define KEYPAD_KEYS			(KEYPAD_ROWS * KEYPAD_COLS)
+
+#define KEY_STAR			(9)		//!< Номер клавиши '*'.
+#define KEY_0				(10)	//!< Номер клавиши '0'.
+#define KEY_HASH			(11)	//!< Номер клавиши '#'.
+
+/**
+ \brief  Типы событий.
+ */
+typedef enum
+{
+	KEYPAD_PRESS = 0,		//!< Клавиша нажата (после подавления дребезга)
+	KEYPAD_RELEASE,			//!< Клавиша отпущена
+	KEYPAD_LONG,			//!< Клавиша удерживается KEYPAD_LONG_MS
+	KEYPAD_REPEAT			//!< Автоповтор при удержании
+}keypad_event_type_t;
+
+/**
+ \struct keypad_event_t
+ \brief Событие клавиатуры.
+ */
+typedef struct keypad_event
+{
+	uint8_t key;			//!< Номер клавиши 0..11
+	uint8_t type;			//!< Тип события (keypad_event_type_t)
+	uint16_t time;			//!< Время события, мс от запуска (по модулю 65536)
+}keypad_event_t;
+
+/**
+\brief Инициализация.
+\details Настраивает выводы и запускает периодический программный таймер
+сканирования. Нужна запущенная служба swtimer.
+*/
+void keypadInit(void);
+
+/**
+\brief Забрать событие из очереди.
+\param ev Куда записать событие.
+\return 1 -- событие есть; 0 -- очередь пуста.
+*/
+uint8_t keypadGetEvent(keypad_event_t *ev);
+
+/**
+\brief Сколько событий потеряно из-за переполнения очереди.
+\details Счетчик сбрасывается при чтении.
+*/
+uint8_t keypadLost(void);
+
+/**
+\brief Бит клавиши в карте keypadState().
+*/
+#define KEYPAD_BIT(key)		((uint16_t)1 << (key))
+
+/**
+\brief Нажатые клавиши.
+\details Состояние после подавления дребезга; обновляется каждый скан.
+\code{.c}
+	if (keypadState() == (KEYPAD_BIT(KEY_STAR) | KEYPAD_BIT(KEY_HASH)))
+		...		// нажаты '*' и '#' одновременно
+\endcode
+\return Битовая карта: бит key установлен -- клавиша нажата.
+*/
+uint16_t keypadState(void);
+
+/**
+\brief Был ли последний скан неоднозначным.
+\return 1 -- возможны фантомные нажатия, скан отброшен; 0 -- нет.
+*/
+uint8_t keypadGhost(void);
+
+/**
+\brief Символ клавиши.
+\param key Номер клавиши 0..11.
+\return ASCII-символ клавиши.
+*/
+char keypadChar(uint8_t key);
+
+#endif /* KEYPAD_H_ */
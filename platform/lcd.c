@@ -20,9 +20,12 @@ the source code.
 
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include <util/delay.h>
 
 #include "gpio.h"
+#include "timer.h"
+#include "timer_claim.h"
 #include "lcd.h"
 
 #define LCD_COLS			(8)
@@ -50,6 +53,10 @@ the source code.
 
 #define	LCD_CDSHIFT_RL	0x04
 
+#define	LCD_BUSY_FLAG		0x80
+#define	LCD_BUSY_TIMEOUT	(2000)		//!< Попыток чтения флага (около 2 мкс каждая), около 4 мс.
+#define	LCD_BUSY_FAILS		(3)			//!< Тайм-аутов подряд, после которых флаг больше не читается.
+
 /**
  \brief  Смещения адреса для строк.
  */
@@ -70,31 +77,252 @@ static inline void initGPIO()
 	DDRB |= (1<<DDB5 | 1<<DDB6 | 1<<DDB7);
 }
 
+#if LCD_USE_BUSY_FLAG
+/**
+\brief Флаг занятости читается. Пока 0 -- используются фиксированные задержки.
+*/
+static uint8_t busyFlagOk;
+static uint8_t busyFails;		//!< Тайм-аутов флага занятости подряд.
+
+/**
+\brief Флаг занятости не сбросился за отведенное время. Внутренняя функция.
+\details Одиночный тайм-аут (например, помеха) не отключает чтение флага,
+только LCD_BUSY_FAILS подряд.
+*/
+static void busyTimeout (void)
+{
+	if (++busyFails >= LCD_BUSY_FAILS)
+		busyFlagOk = 0;
+}
+
+/**
+\brief Читаем флаг занятости и счетчик адреса. Внутренняя функция.
+\return Бит 7 -- флаг занятости (BF), биты 0..6 -- счетчик адреса (AC).
+*/
+static uint8_t readStatus (void)
+{
+	uint8_t status;
+
+	DDRE = 0x00;				// Шина данных на ввод,
+	DATA = 0xFF;				// с подтяжкой: если ЖКИ не ответит, прочтем BF = 1.
+	off(RS);
+	on(RW);
+	on(E);
+	_delay_us(1);				// Время установки данных (tDDR) не более 360 нс.
+	status = PINE;
+	off(E);
+	off(RW);
+	DDRE = 0xFF;
+	return status;
+}
+
+/**
+\brief Ждем, пока контроллер освободится. Внутренняя функция.
+\details Если флаг не сбрасывается с запасом дольше самой медленной команды
+(1,52 мс), выдерживаем ее время и считаем контроллер свободным; после
+нескольких таких тайм-аутов подряд переходим на фиксированные задержки.
+*/
+static void waitReady (void)
+{
+	uint16_t timeout = LCD_BUSY_TIMEOUT;
+
+	if (!busyFlagOk)
+		return;
+	while (readStatus() & LCD_BUSY_FLAG)
+	{
+		if (!--timeout)
+		{
+			busyTimeout();
+			_delay_ms(2);
+			return;
+		}
+	}
+	busyFails = 0;
+}
+#define FIXED_DELAYS()	(!busyFlagOk)
+#else
+#define waitReady()
+#define FIXED_DELAYS()	(1)
+#endif
+
 /**
 \brief Фурмирует импульс на выводе E. Внутренняя функция.
+\details При чтении флага занятости длительность -- 1 мкс (требуется 450 нс),
+иначе выдерживается время выполнения записи (37 мкс).
 */
 static inline
 void strobe ()
 {
 	on(E);
-	_delay_us(20);
+	_delay_us(1);
 	off(E);
-	_delay_us(20);
+	if (FIXED_DELAYS())
+		_delay_us(40);
+}
+
+#if LCD_USE_QUEUE
+#define QUEUE_DATA			(0x100)		//!< Признак записи данных (RS = 1) в элементе очереди.
+#define QUEUE_TICK_US		(50)		//!< Период обработки очереди, мкс. Не меньше времени записи (37 мкс).
+#define QUEUE_LONG_TICKS	(1520 / QUEUE_TICK_US + 1)	//!< Время очистки и возврата курсора (1,52 мс).
+#define QUEUE_BUSY_TICKS	(4000 / QUEUE_TICK_US)		//!< Тайм-аут флага занятости: с запасом к 1,52 мс (медленный генератор ЖКИ).
+
+/**
+\brief Очередь операций: младший байт -- команда или данные, QUEUE_DATA -- RS.
+*/
+static uint16_t queue[LCD_QUEUE_SIZE];
+static volatile uint8_t queue_wr, queue_rd, queue_counter;
+static volatile uint8_t queue_wait;		//!< Сколько тактов ждать выполнения предыдущей команды.
+static uint8_t queueOn;					//!< Очередь запущена (после lcdInit()).
+
+/**
+\brief Ставим операцию в очередь. Внутренняя функция.
+\details Если очередь заполнена, ждем, пока в ней не появится место. Если
+прерывания запрещены (в том числе при вызове из прерывания), очередь не
+освободится, поэтому операция отбрасывается.
+\param entry Элемент очереди.
+\return 0 -- операция в очереди; -1 -- очередь полна, операция отброшена.
+*/
+static int8_t queuePush (uint16_t entry)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	while (queue_counter == LCD_QUEUE_SIZE)	// ждем пока освободится место в очереди
+	{
+		if (!(sreg & (1<<SREG_I)))
+		{
+			SREG = sreg;
+			return (-1);
+		}
+		sei();							// Даем прерыванию таймера 0 разгрузить очередь.
+		cli();
+	}
+	queue[queue_wr++] = entry;
+	if (queue_wr == LCD_QUEUE_SIZE) queue_wr = 0;
+	++queue_counter;
+	TIMSK0 |= (1<<OCIE0A);				// Запускаем обработку очереди.
+	SREG = sreg;
+	return 0;
 }
 
+/**
+\brief Прерывание таймера 0: одна операция с контроллером за такт.
+\details Такт QUEUE_TICK_US больше времени выполнения записи, поэтому
+обычная операция готова к следующему такту. После очистки и возврата
+курсора пропускаем нужное число тактов, либо опрашиваем флаг занятости.
+Когда очередь пуста, прерывание выключается.
+*/
+ISR(TIMER0_COMPA_vect)
+{
+	uint16_t entry;
+
+	if (queue_wait)
+	{
+		queue_wait--;
+		return;
+	}
+	if (!queue_counter)
+	{
+		TIMSK0 &= ~(1<<OCIE0A);
+		return;
+	}
+#if LCD_USE_BUSY_FLAG
+	static uint8_t busy_ticks;
+	if (busyFlagOk)
+	{
+		if (readStatus() & LCD_BUSY_FLAG)
+		{
+			if (++busy_ticks <= QUEUE_BUSY_TICKS)
+				return;
+			busyTimeout();				// Флаг не сбрасывается: считаем, что команда выполнена.
+		}
+		else
+			busyFails = 0;
+		busy_ticks = 0;
+	}
+#endif
+	entry = queue[queue_rd++];
+	if (queue_rd == LCD_QUEUE_SIZE) queue_rd = 0;
+	--queue_counter;
+
+	if (entry & QUEUE_DATA) on(RS);
+	else off(RS);
+	off(RW);
+	DATA = entry;
+	on(E);
+	_delay_us(1);
+	off(E);
+	if (FIXED_DELAYS() && (entry <= (LCD_HOME | 1)))	// Очистка или возврат курсора.
+		queue_wait = QUEUE_LONG_TICKS;
+}
+
+void lcdWait (void)
+{
+	while (queue_counter || queue_wait);
+}
+
+/**
+\brief Запускаем таймер 0 для обработки очереди. Внутренняя функция.
+*/
+static void queueInit (void)
+{
+	if (timerClaim(0, TIMER_COMPARE_A_INT, CLK_DIV_8, CTC_MODE, "lcd") < 0)
+		return;						// Таймер 0 занят: работаем синхронно.
+									// Поэтому канал не занимается при сборке.
+	queue_wr = queue_rd = queue_counter = queue_wait = 0;
+	TCCR0A = (1<<WGM01);							// Режим CTC, TOP = OCR0A.
+	OCR0A = (F_CPU / 8 / 1000000UL) * QUEUE_TICK_US - 1;
+	TCCR0B = (1<<CS01);								// Предделитель: F_CPU/8
+	queueOn = 1;
+}
+#define QUEUED()	(queueOn)
+#else
+#define QUEUED()	(0)
+#endif
+
 /**
 \brief Посылаем команду контроллеру LCD. Внутренняя функция.
-\details Устанавливаем выводы RS и RW  в ноль, на линиях данных устанавливаем
-код команды, посылаем строб. Ждем 2 мс пока контроллер выполнит внутренние действия.
+\details Ждем, пока контроллер освободится, устанавливаем выводы RS и RW в ноль,
+на линиях данных устанавливаем код команды, посылаем строб.
+Если работает очередь, команда только ставится в нее.
 \param command код команды.
 */
-static inline void putCommand (uint8_t command)
+static void putCommand (uint8_t command)
 {
+#if LCD_USE_QUEUE
+	if (queueOn)
+	{
+		queuePush(command);
+		return;
+	}
+#endif
+	waitReady();
 	off(RS);
 	off(RW);
 	DATA =  command;
 	strobe();
-	_delay_us(50);
+	if (FIXED_DELAYS())
+		_delay_us(50);
+}
+
+/**
+\brief Записываем байт в память дисплея (DDRAM или CGRAM). Внутренняя функция.
+\param data байт данных.
+*/
+static void putData (uint8_t data)
+{
+#if LCD_USE_QUEUE
+	if (queueOn)
+	{
+		queuePush(QUEUE_DATA | data);
+		return;
+	}
+#endif
+	waitReady();
+	on(RS);
+	off(RW);
+	DATA = data;
+	strobe();
 }
 
 /**
@@ -113,17 +341,17 @@ void lcdHome (lcd_t *lcd)
 {
   putCommand (LCD_HOME);
   lcd->cx = lcd->cy = 0;
-  _delay_ms(2);				// команда требует дополнительного времени
+  if (!QUEUED() && FIXED_DELAYS())
+    _delay_ms(2);			// команда требует дополнительного времени
 }
 
 
 void lcdClear (lcd_t *lcd)
 {
 
-  putCommand (LCD_CLEAR);
-  _delay_ms(2);				// команда требует дополнительного времени
-  putCommand (LCD_HOME);
-  _delay_ms(2);				// команда требует дополнительного времени
+  putCommand (LCD_CLEAR);		// Очистка сама возвращает курсор в начало.
+  if (!QUEUED() && FIXED_DELAYS())
+    _delay_ms(2);			// команда требует дополнительного времени
   lcd->cx = lcd->cy = 0 ;
 }
 
@@ -159,10 +387,7 @@ void lcdPutchar (lcd_t *lcd, char ch)
 		return;
 	}
 	// Выводим символ.
-	on(RS);
-	off(RW);
-	DATA =  ch;
-	strobe();
+	putData(ch);
 	lcd->cx++;						// Увеличиваем позицию.
 //
 //	if(++lcd->cx == lcd->cols)		// закончились символы в строке
@@ -182,7 +407,7 @@ void lcdPuts (lcd_t *lcd, const char *string)
 
 uint8_t lcdPosition (lcd_t *lcd, uint8_t x, uint8_t y)
 {
-	if ((x > lcd->cols) || (y > lcd->rows))
+	if ((x >= lcd->cols) || (y >= lcd->rows))
 		return (-1);
 	putCommand (x + (LCD_DGRAM | rowOff [y])) ;
 	lcd->cx = x ;
@@ -195,20 +420,57 @@ void lcdCharDef (lcd_t *lcd, uint8_t index, uint8_t *data)
 {
 	uint8_t i ;
 	putCommand (LCD_CGRAM | ((index & 7) << 3)) ;	//устанавливаем адресс DGRAM
-	on(RS);
-	off(RW);
 	for (i = 0 ; i < 8 ; ++i)		// передаем данные в DGRAM
-	{
-		DATA = data[i];
-		strobe();
-	}
+		putData(data[i]);
 	putCommand (lcd->cx + (LCD_DGRAM | rowOff [lcd->cy])) ; // возвращаем курсор в предыдущее место
 }
 
 
+#if LCD_USE_BUSY_FLAG
+uint8_t lcdAddress (lcd_t *lcd)
+{
+#if LCD_USE_QUEUE
+	lcdWait();				// Адрес будет верным после выполнения всей очереди.
+#endif
+	if (!busyFlagOk)
+		return 0xFF;
+	waitReady();
+	return readStatus() & ~LCD_BUSY_FLAG;
+}
+#endif
+
+#if LCD_USE_BUSY_FLAG
+/**
+\brief Проверяем, читается ли флаг занятости. Внутренняя функция.
+\details Вызывается один раз после очистки экрана: контроллер свободен,
+счетчик адреса равен нулю, поэтому исправное чтение дает 0x00. Если линия RW
+не подключена (соединена с землей), строб чтения записывает в контроллер
+подтянутую шину 0xFF -- команду "адрес DDRAM 0x7F". Такой адрес возвращаем
+в начало экрана, а флаг больше не читаем.
+\return 1 -- флаг занятости читается.
+*/
+static uint8_t probeBusyFlag (void)
+{
+	if (readStatus() == 0x00)
+		return 1;
+	_delay_us(40);				// Ложная команда выполняется 37 мкс.
+	putCommand(LCD_DGRAM);		// Флаг еще не используется: с задержками.
+	return 0;
+}
+#endif
+
 void lcdInit(lcd_t *lcd)
 {
 	initGPIO();
+#if LCD_USE_BUSY_FLAG
+	busyFlagOk = 0;			// До настройки интерфейса флаг занятости не читается.
+#endif
+#if LCD_USE_QUEUE
+	lcdWait();				// При повторной инициализации дожидаемся очереди
+	if (queueOn)			// и выполняем настройку синхронно.
+		timerRelease(0, TIMER_COMPARE_A_INT);
+	queueOn = 0;
+#endif
 	lcd->cols = LCD_COLS;
 	lcd->rows = LCD_ROWS;
 	lcd->lcdContrl = 0;
@@ -239,6 +501,12 @@ void lcdInit(lcd_t *lcd)
 	putCommand(LCD_ENTRY   | LCD_ENTRY_ID);
 	//putCommand(LCD_CDSHIFT | LCD_CDSHIFT_RL);
 	lcdClear(lcd);
+#if LCD_USE_BUSY_FLAG
+	busyFlagOk = probeBusyFlag();	// Флаг не читается -- остаемся на задержках.
+#endif
+#if LCD_USE_QUEUE
+	queueInit();			// Дальше все операции идут через очередь.
+#endif
 }
 
 
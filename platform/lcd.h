@@ -23,6 +23,40 @@ the source code.
 
 #include <stdint.h>
 
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Чтение флага занятости контроллера.
+ \details 1 -- перед каждой операцией читается флаг занятости (BF) по линии RW,
+ и операция занимает ровно столько, сколько требуется контроллеру (обычно
+ несколько микросекунд вместо 40..90 мкс на символ и 2 мс на очистку).
+ Читается ли флаг, lcdInit() проверяет один раз; если линия RW не подключена
+ (на земле), модуль остается на фиксированных задержках. 0 -- всегда
+ использовать фиксированные задержки.
+ */
+#define LCD_USE_BUSY_FLAG		1
+
+/**
+ \brief  Неблокирующий вывод через очередь.
+ \details 1 -- после lcdInit() команды и символы только ставятся в очередь,
+ а передает их контроллеру прерывание таймера 0 (CTC, такт 50 мкс), по одной
+ операции за такт с нужными паузами. Функции вывода возвращаются сразу,
+ если в очереди есть место. Требует разрешенных прерываний и занимает таймер 0.
+ Если очередь полна, а прерывания запрещены (вывод из прерывания), операция
+ отбрасывается: ждать бесполезно, очередь разгружает прерывание таймера 0.
+ 0 -- вывод синхронный.
+ */
+#define LCD_USE_QUEUE			0
+
+/**
+ \brief  Размер очереди операций (элемент -- 2 байта ОЗУ).
+ */
+#define LCD_QUEUE_SIZE			32
+/*************************************************************************/
+
 
 /**
  \struct lcd_t
@@ -109,6 +143,24 @@ uint8_t ch[8] =
 */
 void lcdCharDef (lcd_t *lcd, uint8_t index, uint8_t *data);
 
+#if LCD_USE_QUEUE
+/**
+\brief Ждем, пока очередь не будет выполнена.
+\details Нужна там, где важен порядок с другими действиями, например
+перед переводом в спящий режим или чтением счетчика адреса.
+*/
+void lcdWait (void);
+#endif
+
+#if LCD_USE_BUSY_FLAG
+/**
+\brief Читаем счетчик адреса контроллера.
+\param lcd Указатель на структуру с описанием lcd.
+\return Текущий адрес DDRAM/CGRAM; 0xFF -- флаг занятости не читается.
+*/
+uint8_t lcdAddress (lcd_t *lcd);
+#endif
+
 /**
 \brief Включаем отображение курсора
 \param lcd указатель на структуру с описанием lcd.
@@ -0,0 +1,110 @@
+/**
+ \file lcdfb.c
+ \author agent <agent@local>
+ \brief Экранный буфер для LCD стенда LESO6
+ \details Вывод на экран идет в копию экрана в ОЗУ. Функция lcdfbFlush()
+ сравнивает буфер с тем, что уже отображено, и передает контроллеру только
+ изменившиеся знакоместа.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <stdint.h>
+
+#include "lcd.h"
+#include "lcdfb.h"
+
+void lcdfbInit(lcdfb_t *fb, lcd_t *lcd)
+{
+	fb->lcd = lcd;
+	fb->rows = (lcd->rows < LCDFB_ROWS) ? lcd->rows : LCDFB_ROWS;
+	fb->cols = (lcd->cols < LCDFB_COLS) ? lcd->cols : LCDFB_COLS;
+	lcdfbClear(fb);
+	lcdfbInvalidate(fb);
+}
+
+void lcdfbInvalidate(lcdfb_t *fb)
+{
+	fb->invalid = 1;			// Любое значение shown может совпасть с буфером.
+}
+
+void lcdfbClear(lcdfb_t *fb)
+{
+	uint8_t x, y;
+
+	for (y = 0; y < fb->rows; y++)
+		for (x = 0; x < fb->cols; x++)
+			fb->buf[y][x] = ' ';
+	fb->cx = fb->cy = 0;
+}
+
+int8_t lcdfbPosition(lcdfb_t *fb, uint8_t x, uint8_t y)
+{
+	if ((x >= fb->cols) || (y >= fb->rows))
+		return (-1);
+	fb->cx = x;
+	fb->cy = y;
+	return 0;
+}
+
+void lcdfbPutchar(lcdfb_t *fb, char ch)
+{
+	if (ch == '\r')
+	{
+		fb->cx = 0;					// Возврат каретки в начало строки.
+		return;
+	} else if (ch == '\n')
+	{
+		fb->cx = 0;					// начинаем с новой строки
+		if (++fb->cy == fb->rows)	// закончились строки
+			fb->cy = 0;
+		return;
+	}
+	if (fb->cx >= fb->cols)			// За правым краем -- отбрасываем.
+		return;
+	fb->buf[fb->cy][fb->cx++] = ch;
+}
+
+void lcdfbPuts(lcdfb_t *fb, const char *string)
+{
+	while (*string)
+		lcdfbPutchar(fb, *string++);
+}
+
+uint8_t lcdfbFlush(lcdfb_t *fb)
+{
+	lcd_t *lcd = fb->lcd;
+	uint8_t x, y, sent = 0;
+
+	for (y = 0; y < fb->rows; y++)
+	{
+		for (x = 0; x < fb->cols; x++)
+		{
+			if (!fb->invalid && (fb->buf[y][x] == fb->shown[y][x]))
+				continue;
+			// Позицию курсора дисплея отслеживает lcd.c в lcd->cx, lcd->cy.
+			if ((lcd->cy == y) && (lcd->cx + 1 == x))
+			{	// Пропущен один символ: передать его дешевле, чем ставить курсор.
+				lcdPutchar(lcd, fb->buf[y][x - 1]);
+				sent++;
+			}
+			if ((lcd->cy != y) || (lcd->cx != x))
+				lcdPosition(lcd, x, y);
+			lcdPutchar(lcd, fb->buf[y][x]);
+			fb->shown[y][x] = fb->buf[y][x];
+			sent++;
+		}
+	}
+	fb->invalid = 0;
+	return sent;
+}
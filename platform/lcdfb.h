@@ -0,0 +1,123 @@
+/**
+ \file lcdfb.h
+ \author agent <agent@local>
+ \brief Экранный буфер для LCD стенда LESO6
+ \details Вывод на экран идет в копию экрана в ОЗУ. Функция lcdfbFlush()
+ сравнивает буфер с тем, что уже отображено, и передает контроллеру только
+ изменившиеся знакоместа, с минимумом команд установки курсора. Например,
+ обновление часов стоит передачи одного-двух символов вместо перерисовки строки.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef LCDFB_H_
+#define LCDFB_H_
+
+#include <stdint.h>
+#include "lcd.h"
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Максимальное количество строк экрана.
+ */
+#define LCDFB_ROWS			(2)
+
+/**
+ \brief  Максимальное количество столбцов экрана.
+ \details Буфер занимает в ОЗУ 2 * LCDFB_ROWS * LCDFB_COLS байт.
+ */
+#define LCDFB_COLS			(8)
+/*************************************************************************/
+
+/**
+ \struct lcdfb_t
+ \brief Структура экранного буфера.
+ */
+typedef struct lcdfb
+{
+	lcd_t *lcd;								//!< Дисплей, на который выводится буфер
+	uint8_t rows;							//!< Количество строк
+	uint8_t cols;							//!< Количество столбцов
+	uint8_t cx, cy;							//!< Текущая позиция записи в буфере
+	char buf[LCDFB_ROWS][LCDFB_COLS];		//!< Содержимое, которое должно быть на экране
+	char shown[LCDFB_ROWS][LCDFB_COLS];		//!< Содержимое, которое сейчас на экране
+	uint8_t invalid;						//!< shown неизвестно, перерисовать все
+}lcdfb_t;
+
+/**
+\brief Инициализация буфера.
+\details Заполняет буфер пробелами. Содержимое экрана считается неизвестным,
+поэтому первый lcdfbFlush() перерисует его целиком.
+\param fb Указатель на буфер.
+\param lcd Указатель на структуру с описанием lcd, уже инициализированную lcdInit().
+*/
+void lcdfbInit(lcdfb_t *fb, lcd_t *lcd);
+
+/**
+\brief Помечает весь экран как неизвестный.
+\details Вызывается, если на экран выводили в обход буфера (lcdPuts(), lcdClear()).
+Следующий lcdfbFlush() перерисует экран целиком.
+\param fb Указатель на буфер.
+*/
+void lcdfbInvalidate(lcdfb_t *fb);
+
+/**
+\brief Очищает буфер.
+\details Заполняет буфер пробелами, позиция записи -- в начало. На экран
+ничего не передается до вызова lcdfbFlush().
+\param fb Указатель на буфер.
+*/
+void lcdfbClear(lcdfb_t *fb);
+
+/**
+\brief Устанавливает позицию записи.
+\param fb Указатель на буфер.
+\param x Позиция в строке.
+\param y Номер строки.
+\return 0 -- позиция установлена; -1 -- позиция выходит за пределы экрана.
+*/
+int8_t lcdfbPosition(lcdfb_t *fb, uint8_t x, uint8_t y);
+
+/**
+\brief Записывает символ в буфер.
+\details Символы '\r' и '\n' обрабатываются как в lcdPutchar(). Символы за
+правым краем строки отбрасываются.
+\param fb Указатель на буфер.
+\param ch Код символа.
+*/
+void lcdfbPutchar(lcdfb_t *fb, char ch);
+
+/**
+\brief Записывает строку в буфер.
+\param fb Указатель на буфер.
+\param string Указатель на строку.
+*/
+void lcdfbPuts(lcdfb_t *fb, const char *string);
+
+/**
+\brief Выводит изменения на экран.
+\details Передает только знакоместа, отличающиеся от отображенных. Курсор
+переставляется, только если следующее изменение не идет сразу за предыдущим;
+одиночный неизменный символ между изменениями передается повторно -- это
+быстрее команды установки курсора.
+\note После вызова курсор дисплея остается за последним переданным символом.
+\param fb Указатель на буфер.
+\return Количество переданных символов.
+*/
+uint8_t lcdfbFlush(lcdfb_t *fb);
+
+#endif /* LCDFB_H_ */
@@ -0,0 +1,102 @@
+/**
+ \file lcdglyph.c
+ \author agent <agent@local>
+ \brief Менеджер пользовательских символов LCD стенда LESO6
+ \details Распределяет ячейки CGRAM между изображениями символов,
+ вытесняя давно не использованные (LRU).
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "lcd.h"
+#include "lcdglyph.h"
+
+/**
+ \brief  Копия изображения в каждой ячейке.
+ \details Ячейки ищутся по содержимому, а не по адресу: один буфер в ОЗУ
+ можно заполнять разными изображениями, а одинаковые изображения из разных
+ массивов займут одну ячейку.
+ */
+static uint8_t slot_glyph[LCDGLYPH_SLOTS][8];
+
+/**
+ \brief  Занятые ячейки (бит на ячейку).
+ */
+static uint8_t slot_used;
+
+/**
+ \brief  Порядок использования занятых ячеек: 0 -- последняя использованная.
+ \details У n занятых ячеек значения всегда образуют перестановку 0 .. n - 1,
+ поэтому не насыщаются при любом числе обращений. Когда заняты все ячейки,
+ дольше всех не использованная имеет номер LCDGLYPH_SLOTS - 1.
+ */
+static uint8_t slot_rank[LCDGLYPH_SLOTS];
+
+/**
+\brief Отметить ячейку как последнюю использованную. Внутренняя функция.
+*/
+static void touch (uint8_t slot)
+{
+	uint8_t i, rank = slot_rank[slot];
+
+	for (i = 0; i < LCDGLYPH_SLOTS; i++)	// Все, что было новее, стареет на 1.
+		if ((slot_used & (1 << i)) && (slot_rank[i] < rank))
+			slot_rank[i]++;
+	slot_rank[slot] = 0;
+}
+
+uint8_t lcdGlyph (lcd_t *lcd, const uint8_t *glyph)
+{
+	uint8_t i, used = 0, slot = LCDGLYPH_SLOTS;
+
+	for (i = 0; i < LCDGLYPH_SLOTS; i++)	// Уже загружено?
+		if ((slot_used & (1 << i)) && !memcmp(slot_glyph[i], glyph, 8))
+		{
+			slot = i;
+			break;
+		}
+
+	if (slot == LCDGLYPH_SLOTS)				// Выбираем ячейку для загрузки:
+	{
+		for (i = 0; i < LCDGLYPH_SLOTS; i++)
+		{
+			if (!(slot_used & (1 << i)))	// свободную,
+			{
+				if (slot == LCDGLYPH_SLOTS)
+					slot = i;
+			}
+			else used++;
+		}
+		if (slot == LCDGLYPH_SLOTS)			// либо самую старую.
+		{
+			for (slot = 0; slot_rank[slot] != LCDGLYPH_SLOTS - 1; slot++);
+			used--;							// Ее место в порядке освобождается.
+		}
+		memcpy(slot_glyph[slot], glyph, 8);
+		slot_rank[slot] = used;				// Новая ячейка -- за всеми занятыми,
+		slot_used |= 1 << slot;				// touch() переставит ее в начало.
+		lcdCharDef(lcd, LCDGLYPH_FIRST + slot, slot_glyph[slot]);
+	}
+
+	touch(slot);
+	return LCDGLYPH_FIRST + slot;
+}
+
+void lcdGlyphReset (void)
+{
+	slot_used = 0;
+}
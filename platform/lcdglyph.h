@@ -0,0 +1,73 @@
+/**
+ \file lcdglyph.h
+ \author agent <agent@local>
+ \brief Менеджер пользовательских символов LCD стенда LESO6
+ \details Контроллер HD44780 хранит 8 пользовательских символов в CGRAM.
+ Менеджер сам распределяет ячейки CGRAM между изображениями: приложение
+ передает изображение и получает код символа для вывода. Изображение с
+ тем же содержимым, уже находящееся в CGRAM, повторно не загружается; при нехватке ячеек
+ вытесняется давно не использованное (LRU).
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef LCDGLYPH_H_
+#define LCDGLYPH_H_
+
+#include <stdint.h>
+#include "lcd.h"
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Первая ячейка CGRAM, отданная менеджеру.
+ \details Ячейки с меньшими номерами остаются для lcdCharDef().
+ */
+#define LCDGLYPH_FIRST		(0)
+
+/**
+ \brief  Количество ячеек CGRAM, отданных менеджеру.
+ */
+#define LCDGLYPH_SLOTS		(8 - LCDGLYPH_FIRST)
+/*************************************************************************/
+
+/**
+\brief Получить код символа для изображения.
+\details Если изображение уже загружено в CGRAM, возвращает его код, ничего
+не передавая контроллеру. Иначе загружает его на место свободной или
+дольше всех не использованной ячейки (8 записей в CGRAM и возврат курсора).
+Изображения различаются по содержимому (менеджер хранит копию, 64 байта
+ОЗУ), поэтому массив может быть временным или переиспользоваться, например
+буфер, в котором строятся столбцы диаграммы.
+\note Символы, уже выведенные на экран с кодом вытесненного изображения,
+сменят вид. Одновременно на экране должно быть не больше LCDGLYPH_SLOTS
+разных изображений.
+\note Код 0 нельзя вставить в строку (это конец строки), его выводят
+через lcdPutchar().
+\param lcd Указатель на структуру с описанием lcd.
+\param glyph Указатель на массив из 8-ми байт с изображением (см. lcdCharDef()).
+\return Код символа (LCDGLYPH_FIRST .. 7).
+*/
+uint8_t lcdGlyph (lcd_t *lcd, const uint8_t *glyph);
+
+/**
+\brief Забыть содержимое CGRAM.
+\details Вызывается, если ячейки менеджера перезаписаны через lcdCharDef()
+или дисплей был обесточен. Следующие lcdGlyph() загрузят изображения заново.
+*/
+void lcdGlyphReset (void);
+
+#endif /* LCDGLYPH_H_ */
@@ -0,0 +1,228 @@
+/**
+ \file lcdscreen.c
+ \author agent <agent@local>
+ \brief Экраны, бегущие строки и оповещения на LCD стенда LESO6
+ \details Страницы из областей с текстом, смена страниц по времени,
+ оповещения с приоритетом. Анимация -- в screenTick().
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "lcdfb.h"
+#include "lcdscreen.h"
+
+/**
+ \brief  Оповещение.
+ */
+typedef struct screen_overlay
+{
+	screen_page_t *page;		//!< Страница; NULL -- место свободно
+	uint8_t priority;			//!< Приоритет
+	uint16_t ticks;				//!< Осталось тактов; 0 -- без ограничения
+}screen_overlay_t;
+
+static lcdfb_t *screen_fb;
+static screen_page_t *screen_pages;
+static uint8_t screen_npages;
+static uint8_t screen_current;				//!< Номер показываемой страницы.
+static uint16_t screen_elapsed;				//!< Тактов показа текущей страницы.
+static screen_overlay_t screen_overlays[SCREEN_OVERLAYS];
+static screen_page_t *screen_shown;			//!< Что было на экране в прошлый такт.
+
+/**
+\brief Возвращает бегущие строки страницы в начало. Внутренняя функция.
+*/
+static void resetPage(screen_page_t *page)
+{
+	uint8_t i;
+
+	for (i = 0; i < page->nregions; i++)
+	{
+		page->regions[i].offset = 0;
+		page->regions[i].delay = page->regions[i].speed;
+	}
+}
+
+/**
+\brief Собирает страницу в экранном буфере и сдвигает бегущие строки. Внутренняя функция.
+*/
+static void renderPage(screen_page_t *page)
+{
+	screen_region_t *r;
+	uint8_t i, x, len, period, pos;
+
+	lcdfbClear(screen_fb);
+	for (i = 0; i < page->nregions; i++)
+	{
+		r = &page->regions[i];
+		if (r->text == NULL)
+			continue;
+		if (lcdfbPosition(screen_fb, r->x, r->y))	// Область вне экрана.
+			continue;
+		len = strlen(r->text);
+		if (!r->speed || (len <= r->width))		// Текст помещается.
+		{
+			for (x = 0; x < r->width && x < len; x++)
+				lcdfbPutchar(screen_fb, r->text[x]);
+			continue;
+		}
+		// Бегущая строка: текст, затем SCREEN_MARQUEE_GAP пробелов, по кругу.
+		period = len + SCREEN_MARQUEE_GAP;
+		if (r->offset >= period)
+			r->offset = 0;
+		pos = r->offset;
+		for (x = 0; x < r->width; x++)
+		{
+			lcdfbPutchar(screen_fb, (pos < len) ? r->text[pos] : ' ');
+			if (++pos == period)
+				pos = 0;
+		}
+		if (!--r->delay)
+		{
+			r->delay = r->speed;
+			r->offset++;
+		}
+	}
+}
+
+/**
+\brief Самое важное активное оповещение. Внутренняя функция.
+\return Номер в screen_overlays; SCREEN_OVERLAYS -- оповещений нет.
+*/
+static uint8_t topOverlay(void)
+{
+	uint8_t i, top = SCREEN_OVERLAYS;
+
+	for (i = 0; i < SCREEN_OVERLAYS; i++)
+		if (screen_overlays[i].page &&
+			((top == SCREEN_OVERLAYS) || (screen_overlays[i].priority > screen_overlays[top].priority)))
+			top = i;
+	return top;
+}
+
+void screenInit(lcdfb_t *fb, screen_page_t *pages, uint8_t npages)
+{
+	uint8_t i;
+
+	screen_fb = fb;
+	screen_pages = pages;
+	screen_npages = npages;
+	for (i = 0; i < SCREEN_OVERLAYS; i++)
+		screen_overlays[i].page = NULL;
+	screen_shown = NULL;
+	screenShow(0);
+}
+
+int8_t screenFind(const char *name)
+{
+	uint8_t i;
+
+	for (i = 0; i < screen_npages; i++)
+		if (!strcmp(screen_pages[i].name, name))
+			return i;
+	return (-1);
+}
+
+void screenShow(uint8_t page)
+{
+	if (page >= screen_npages)
+		return;
+	screen_current = page;
+	screen_elapsed = 0;
+	resetPage(&screen_pages[page]);
+}
+
+int8_t screenAlert(screen_page_t *page, uint8_t priority, uint16_t ticks)
+{
+	uint8_t i, slot = SCREEN_OVERLAYS;
+
+	for (i = 0; i < SCREEN_OVERLAYS; i++)
+	{
+		if (screen_overlays[i].page == page)	// Уже показывается -- обновляем.
+		{
+			slot = i;
+			break;
+		}
+		if (!screen_overlays[i].page)
+			slot = i;
+	}
+	if (slot == SCREEN_OVERLAYS)		// Мест нет -- вытесняем наименее важное.
+	{
+		slot = 0;
+		for (i = 1; i < SCREEN_OVERLAYS; i++)
+			if (screen_overlays[i].priority < screen_overlays[slot].priority)
+				slot = i;
+		if (screen_overlays[slot].priority >= priority)
+			return (-1);			// Равное не вытесняем: первое еще не показано.
+	}
+	if (screen_overlays[slot].page != page)
+		resetPage(page);
+	screen_overlays[slot].priority = priority;
+	screen_overlays[slot].ticks = ticks;
+	screen_overlays[slot].page = page;
+	return 0;
+}
+
+void screenAlertClear(screen_page_t *page)
+{
+	uint8_t i;
+
+	for (i = 0; i < SCREEN_OVERLAYS; i++)
+		if (screen_overlays[i].page == page)
+			screen_overlays[i].page = NULL;
+}
+
+void screenTick(void)
+{
+	screen_page_t *page;
+	uint8_t i, next;
+
+	if (!screen_npages)
+		return;
+
+	for (i = 0; i < SCREEN_OVERLAYS; i++)		// Снимаем истекшие оповещения.
+		if (screen_overlays[i].page && screen_overlays[i].ticks && !--screen_overlays[i].ticks)
+			screen_overlays[i].page = NULL;
+
+	i = topOverlay();
+	if (i != SCREEN_OVERLAYS)
+		page = screen_overlays[i].page;		// Под оповещением страницы не меняются.
+	else
+	{
+		page = &screen_pages[screen_current];
+		if (page->duration && (++screen_elapsed >= page->duration))
+		{	// Следующая страница, участвующая в смене.
+			next = screen_current;
+			do
+			{
+				if (++next == screen_npages)
+					next = 0;
+			} while (!screen_pages[next].duration && (next != screen_current));
+			screenShow(next);
+			page = &screen_pages[screen_current];
+		}
+	}
+
+	if (page != screen_shown)		// Новая страница: бегущие строки с начала.
+	{
+		if (screen_shown != NULL)
+			resetPage(page);
+		screen_shown = page;
+	}
+	renderPage(page);
+	lcdfbFlush(screen_fb);
+}
@@ -0,0 +1,146 @@
+/**
+ \file lcdscreen.h
+ \author agent <agent@local>
+ \brief Экраны, бегущие строки и оповещения на LCD стенда LESO6
+ \details Экран (страница) состоит из областей: участков строк, в которые
+ выводится текст. Текст длиннее области прокручивается бегущей строкой.
+ Страницы с ненулевой длительностью показываются по очереди. Поверх них
+ можно вывести оповещение с приоритетом и временем показа.
+
+ Вся анимация выполняется в screenTick(), которую вызывают из основного
+ цикла с постоянным периодом (например, раз в 100 мс по флагу, который
+ выставляет функция программного таймера swtimer.h). Каждый такт экран
+ собирается в экранном буфере (lcdfb.h), и на дисплей передаются только
+ изменившиеся символы. Приложению достаточно менять тексты областей --
+ изменения появятся на следующем такте.
+\code{.c}
+	char temp_str[9], time_str[9];
+	screen_region_t main_regions[] = {
+		{ 0, 0, 8, time_str, 0 },
+		{ 0, 1, 8, temp_str, 0 },
+	};
+	screen_region_t info_regions[] = {
+		{ 0, 0, 8, "LESO6", 0 },
+		{ 0, 1, 8, "ATMEGA128RFA1 www.labfor.ru", 3 },	// сдвиг раз в 3 такта
+	};
+	screen_page_t pages[] = {
+		{ "main", main_regions, 2, 50 },	// 5 с при такте 100 мс
+		{ "info", info_regions, 2, 30 },
+	};
+	screenInit(&fb, pages, 2);
+\endcode
+ \note screenTick() нельзя вызывать из прерывания: она ждет дисплей (или
+ место в очереди LCD_USE_QUEUE) и читает тексты областей, которые в это
+ время может менять основной цикл. Области вне экрана не выводятся.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef LCDSCREEN_H_
+#define LCDSCREEN_H_
+
+#include <stdint.h>
+#include "lcdfb.h"
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Сколько оповещений может быть активно одновременно.
+ */
+#define SCREEN_OVERLAYS		(2)
+
+/**
+ \brief  Пробелов между концом и началом бегущей строки.
+ */
+#define SCREEN_MARQUEE_GAP	(2)
+/*************************************************************************/
+
+/**
+ \struct screen_region_t
+ \brief Область экрана с текстом.
+ */
+typedef struct screen_region
+{
+	uint8_t x, y;				//!< Начало области
+	uint8_t width;				//!< Ширина области, символов
+	const char *text;			//!< Текст (строка в ОЗУ, может меняться приложением)
+	uint8_t speed;				//!< Тактов на сдвиг бегущей строки; 0 -- без прокрутки
+	uint8_t offset;				//!< Текущий сдвиг бегущей строки (внутреннее)
+	uint8_t delay;				//!< Счетчик тактов до сдвига (внутреннее)
+}screen_region_t;
+
+/**
+ \struct screen_page_t
+ \brief Страница экрана.
+ */
+typedef struct screen_page
+{
+	const char *name;			//!< Имя страницы
+	screen_region_t *regions;	//!< Массив областей
+	uint8_t nregions;			//!< Количество областей
+	uint16_t duration;			//!< Тактов показа при смене страниц; 0 -- только по screenShow()
+}screen_page_t;
+
+/**
+\brief Инициализация.
+\details Показывает первую страницу.
+\param fb Указатель на инициализированный экранный буфер.
+\param pages Массив страниц.
+\param npages Количество страниц.
+*/
+void screenInit(lcdfb_t *fb, screen_page_t *pages, uint8_t npages);
+
+/**
+\brief Найти страницу по имени.
+\param name Имя страницы.
+\return Номер страницы; -1 -- страницы нет.
+*/
+int8_t screenFind(const char *name);
+
+/**
+\brief Показать страницу.
+\details Смена страниц продолжится с этой страницы.
+\param page Номер страницы.
+*/
+void screenShow(uint8_t page);
+
+/**
+\brief Показать оповещение поверх страниц.
+\details Показывается оповещение с наибольшим приоритетом. Если все места
+заняты, вытесняется оповещение со строго меньшим приоритетом; оповещение
+с равным приоритетом не вытесняется.
+\param page Страница оповещения (не обязана входить в массив страниц).
+\param priority Приоритет, больше -- важнее.
+\param ticks Время показа в тактах; 0 -- до screenAlertClear().
+\return 0 -- оповещение показано; -1 -- все места заняты не менее важными.
+*/
+int8_t screenAlert(screen_page_t *page, uint8_t priority, uint16_t ticks);
+
+/**
+\brief Убрать оповещение.
+\param page Страница оповещения.
+*/
+void screenAlertClear(screen_page_t *page);
+
+/**
+\brief Такт анимации.
+\details Сдвигает бегущие строки, меняет страницы, снимает истекшие
+оповещения и передает на дисплей изменившиеся символы. Вызывается только
+из основного цикла, не из прерывания.
+*/
+void screenTick(void);
+
+#endif /* LCDSCREEN_H_ */
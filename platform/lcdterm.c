@@ -0,0 +1,219 @@
+/**
+ \file lcdterm.c
+ \author agent <agent@local>
+ \brief Терминал на LCD стенда LESO6
+ \details Эмуляция простого терминала поверх экранного буфера:
+ перенос строк, прокрутка, подмножество управляющих последовательностей ANSI.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "lcd.h"
+#include "lcdfb.h"
+#include "lcdterm.h"
+
+#define TERM_NORMAL		(0)		//!< Обычный вывод.
+#define TERM_ESC		(1)		//!< Принят ESC.
+#define TERM_CSI		(2)		//!< Принят ESC [, идут параметры.
+
+/**
+\brief Заполняет часть строки пробелами. Внутренняя функция.
+\param fb Указатель на буфер.
+\param y Номер строки.
+\param from Первый столбец.
+\param to Столбец за последним.
+*/
+static void clearRow(lcdfb_t *fb, uint8_t y, uint8_t from, uint8_t to)
+{
+	if (to > fb->cols)
+		to = fb->cols;
+	if (from < to)
+		memset(&fb->buf[y][from], ' ', to - from);
+}
+
+/**
+\brief Переход на следующую строку с прокруткой. Внутренняя функция.
+\details Прокрутка -- сдвиг строк буфера вверх; на экран уйдут только
+символы, которые при этом изменились.
+*/
+static void newLine(lcdfb_t *fb)
+{
+	fb->cx = 0;
+	if (fb->cy + 1 < fb->rows)
+	{
+		fb->cy++;
+		return;
+	}
+	memmove(&fb->buf[0][0], &fb->buf[1][0], (fb->rows - 1) * sizeof(fb->buf[0]));
+	clearRow(fb, fb->rows - 1, 0, fb->cols);
+}
+
+/**
+\brief Выполняет управляющую последовательность ESC [ ... . Внутренняя функция.
+\param term Указатель на терминал.
+\param cmd Завершающий символ последовательности.
+*/
+static void doCSI(lcdterm_t *term, char cmd)
+{
+	lcdfb_t *fb = term->fb;
+	uint8_t n = term->param[0];
+	uint8_t y;
+
+	switch (cmd)
+	{
+	case 'A':
+		if (!n) n = 1;
+		fb->cy = (fb->cy > n) ? fb->cy - n : 0;
+		break;
+	case 'B':
+		if (!n) n = 1;
+		fb->cy = (fb->cy + n < fb->rows) ? fb->cy + n : fb->rows - 1;
+		break;
+	case 'C':
+		if (!n) n = 1;
+		fb->cx = (fb->cx + n < fb->cols) ? fb->cx + n : fb->cols - 1;
+		break;
+	case 'D':
+		if (!n) n = 1;
+		fb->cx = (fb->cx > n) ? fb->cx - n : 0;
+		break;
+	case 'H':
+	case 'f':
+		y = n ? n - 1 : 0;
+		n = term->param[1] ? term->param[1] - 1 : 0;
+		fb->cy = (y < fb->rows) ? y : fb->rows - 1;
+		fb->cx = (n < fb->cols) ? n : fb->cols - 1;
+		break;
+	case 'K':
+		if (n == 0) clearRow(fb, fb->cy, fb->cx, fb->cols);
+		else if (n == 1) clearRow(fb, fb->cy, 0, fb->cx + 1);
+		else clearRow(fb, fb->cy, 0, fb->cols);
+		break;
+	case 'J':
+		if (n == 2)
+		{
+			for (y = 0; y < fb->rows; y++)
+				clearRow(fb, y, 0, fb->cols);
+		} else if (n == 0)
+		{
+			clearRow(fb, fb->cy, fb->cx, fb->cols);
+			for (y = fb->cy + 1; y < fb->rows; y++)
+				clearRow(fb, y, 0, fb->cols);
+		}
+		break;
+	default:						// Неподдерживаемые последовательности пропускаем.
+		break;
+	}
+}
+
+void lcdtermPutchar(lcdterm_t *term, char ch)
+{
+	lcdfb_t *fb = term->fb;
+
+	if (term->state == TERM_ESC)
+	{
+		if (ch == '[')
+		{
+			term->state = TERM_CSI;
+			term->param[0] = term->param[1] = 0;
+			term->nparam = 0;
+		} else
+			term->state = TERM_NORMAL;
+		return;
+	}
+	if (term->state == TERM_CSI)
+	{
+		if ((ch >= '0') && (ch <= '9'))
+		{
+			if (term->nparam < 2)
+				term->param[term->nparam] = term->param[term->nparam] * 10 + (ch - '0');
+		} else if (ch == ';')
+			term->nparam++;
+		else
+		{
+			term->state = TERM_NORMAL;
+			doCSI(term, ch);
+		}
+		return;
+	}
+
+	switch (ch)
+	{
+	case '\033':
+		term->state = TERM_ESC;
+		break;
+	case '\r':
+		fb->cx = 0;
+		break;
+	case '\n':
+		newLine(fb);
+		break;
+	case '\b':
+		if (fb->cx)
+			fb->cx--;
+		break;
+	default:
+		if (fb->cx >= fb->cols)		// Строка закончилась -- переносим.
+			newLine(fb);
+		fb->buf[fb->cy][fb->cx++] = ch;
+		break;
+	}
+}
+
+void lcdtermPuts(lcdterm_t *term, const char *string)
+{
+	while (*string)
+		lcdtermPutchar(term, *string++);
+}
+
+void lcdtermFlush(lcdterm_t *term)
+{
+	lcdfb_t *fb = term->fb;
+	uint8_t x;
+
+	lcdfbFlush(fb);
+	// После последнего символа строки курсор остается на нем.
+	x = (fb->cx < fb->cols) ? fb->cx : fb->cols - 1;
+	if ((fb->lcd->cx != x) || (fb->lcd->cy != fb->cy))
+		lcdPosition(fb->lcd, x, fb->cy);
+}
+
+/**
+\brief Функция вывода символа для потока stdio. Внутренняя функция.
+*/
+static int lcdtermStreamPut(char ch, FILE *stream)
+{
+	lcdterm_t *term = (lcdterm_t *)fdev_get_udata(stream);
+
+	lcdtermPutchar(term, ch);
+	if (term->state == TERM_NORMAL)	// Середину последовательности не показываем.
+		lcdtermFlush(term);
+	return 0;
+}
+
+void lcdtermInit(lcdterm_t *term, lcdfb_t *fb, FILE *stream)
+{
+	term->fb = fb;
+	term->state = TERM_NORMAL;
+	term->nparam = 0;
+	lcdfbClear(fb);
+	if (stream != NULL)
+	{
+		fdev_setup_stream(stream, lcdtermStreamPut, NULL, _FDEV_SETUP_WRITE);
+		fdev_set_udata(stream, term);
+	}
+}
@@ -0,0 +1,92 @@
+/**
+ \file lcdterm.h
+ \author agent <agent@local>
+ \brief Терминал на LCD стенда LESO6
+ \details Эмуляция простого терминала поверх экранного буфера (lcdfb.h):
+ автоматический перенос строк, прокрутка вверх, подмножество
+ управляющих последовательностей ANSI и поток вывода stdio. Один и тот же
+ код вывода (printf() с "\r\033[K" и т.п.) работает и с терминалом по UART,
+ и с ЖКИ. Прокрутка -- сдвиг строк буфера в ОЗУ, на экран передаются
+ только изменившиеся символы.
+
+ Поддерживаемые символы и последовательности:
+\code
+	\r            -- в начало строки
+	\n            -- в начало следующей строки, на последней строке -- прокрутка
+	\b            -- на символ влево
+	ESC [ n A/B/C/D  -- курсор вверх/вниз/вправо/влево на n (по умолчанию 1)
+	ESC [ y ; x H    -- курсор в строку y, столбец x (с 1; по умолчанию 1;1)
+	ESC [ n K        -- очистка строки: 0 -- до конца, 1 -- до курсора, 2 -- всей
+	ESC [ n J        -- очистка экрана: 0 -- до конца, 2 -- всего
+\endcode
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef LCDTERM_H_
+#define LCDTERM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include "lcdfb.h"
+
+/**
+ \struct lcdterm_t
+ \brief Состояние терминала.
+ */
+typedef struct lcdterm
+{
+	lcdfb_t *fb;				//!< Экранный буфер
+	uint8_t state;				//!< Состояние разбора управляющей последовательности
+	uint8_t param[2];			//!< Числовые параметры последовательности
+	uint8_t nparam;				//!< Номер текущего параметра
+}lcdterm_t;
+
+/**
+\brief Инициализация терминала.
+\details Очищает буфер. Если передан поток, настраивает его на вывод в
+терминал: каждый символ сразу отображается на экране.
+\code{.c}
+	FILE lcd_out;
+	lcdterm_t term;
+	lcdtermInit(&term, &fb, &lcd_out);
+	fprintf(&lcd_out, "\r\033[K%02u:%02u", h, m);
+\endcode
+\param term Указатель на терминал.
+\param fb Указатель на инициализированный экранный буфер.
+\param stream Поток для вывода через stdio, либо NULL.
+*/
+void lcdtermInit(lcdterm_t *term, lcdfb_t *fb, FILE *stream);
+
+/**
+\brief Выводит символ в буфер терминала.
+\details На экран ничего не передается до вызова lcdtermFlush().
+\param term Указатель на терминал.
+\param ch Символ или часть управляющей последовательности.
+*/
+void lcdtermPutchar(lcdterm_t *term, char ch);
+
+/**
+\brief Выводит строку в буфер терминала.
+\param term Указатель на терминал.
+\param string Указатель на строку.
+*/
+void lcdtermPuts(lcdterm_t *term, const char *string);
+
+/**
+\brief Передает изменения на экран и ставит курсор дисплея в позицию терминала.
+\param term Указатель на терминал.
+*/
+void lcdtermFlush(lcdterm_t *term);
+
+#endif /* LCDTERM_H_ */
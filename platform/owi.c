@@ -0,0 +1,272 @@
+/**
+ \file owi.c
+ \author Shauerman Alexander <shamrel@yandex.ru>  www.labfor.ru
+ \brief Библиотека для работы с однопроводным интерфейсом 1-Wire стенда LESO6.
+ \details Библиотека содержит функции нижнего уровня для шины 1-Wire
+ (One Wire Interface -- OWI): сброс, слоты записи и чтения, поиск устройств.
+ Временные слоты формируются программно (задержками на выводе PB4), либо
+ аппаратно -- приемопередатчиком USART0 (см. OWI_USART).
+ \version   0.1
+ \date 4.12.2014
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+
+#include "owi.h"
+
+#ifndef OWI_USART
+// ========================================================================
+//                 Программная реализация временных слотов
+
+#define OWI_PORT 	PORTB
+#define OWI_PIN 	PINB
+#define OWI_DDR 	DDRB
+#define OWI_BIT		(4)
+
+#define OWN_HIGH()		{ OWI_DDR &= ~(1<<OWI_BIT);}	//!< Отпускаем линию. Конфигурируем ее на ввод.
+#define OWN_LOW()		{ OWI_DDR |= (1<<OWI_BIT);}		//!< Устанавливаем ноль. Конфигурируем ее на вывод.
+
+void OWI_write_bit(uint8_t bit)
+{
+	// инициализируем таймслот
+	OWN_LOW();						// Удерживаем шину в нуле 1 мкс.
+	_delay_us(2);
+	if(bit) OWN_HIGH(); 			// Если требуется передать "1", то отпускаем шину.
+	_delay_us(60);					// Ждем пока приемник воспримет бит.
+	OWN_HIGH(); 					// Отпускаем шину.
+	_delay_us(2);
+}
+
+uint8_t OWI_read_bit(void)
+{
+	uint8_t bit;
+	// инициализируем таймслот
+	OWN_LOW();							// Удерживаем шину в нуле 1 мкс.
+	_delay_us(1);
+	OWN_HIGH();							// Отпускаем шину.
+	_delay_us(15);
+	bit = OWI_PIN&(1<<OWI_BIT) ? 1:0;	// Читаем состояние шины.
+	_delay_us(45);						// Дожидаемся конца таймслота.
+	return bit;
+}
+
+void OWI_write_byte(uint8_t byte)
+{
+	uint8_t i;
+	for(i=0; i<8; i++) OWI_write_bit(byte&(1 << i));
+}
+
+uint8_t OWI_read_byte(void)
+{
+	uint8_t i, byte = 0;
+
+	for(i=0; i<8; i++)	byte |=  OWI_read_bit() << i;
+
+	return byte;
+}
+
+uint8_t OWI_presence(void)
+{
+	uint8_t	status;
+
+	status = OWI_PIN&(1<<OWI_BIT) ? 1:0;	// Читаем состояние шины.
+	if(!status) return status;				// Если на шине уже был ноль, значит либо сбой,
+											// либо преобразование еще не завершено.
+	OWI_PORT &= ~(1<<OWI_BIT);				// Записываем в регистр вывода ноль.
+	OWN_LOW();								// Устанавливаем ноль на линии.
+	_delay_us(480);
+	OWN_HIGH();								// Отпускаем шину.
+	_delay_us(60);							// Ждем пока устроство ответит.
+	status = OWI_PIN&(1<<OWI_BIT) ? 0:1;	// Читаем состояние шины.
+	_delay_us(420);
+
+	return status;
+}
+
+#else
+// ========================================================================
+//                 Аппаратная реализация временных слотов на USART0
+
+#define OWI_UBRR_RESET	((F_CPU / 16 / 9600) - 1)		//!< 9600 бит/с: байт 0xF0 -- импульс сброса 520 мкс.
+#define OWI_UBRR_SLOT	((F_CPU / 8 / 115200) - 1)		//!< 115200 бит/с (U2X): байт -- слот 78 мкс.
+
+/**
+ \brief  Сбросить флаг TXC0 (запись 1) перед записью в UDR0.
+ \details FE0, DOR0, UPE0 при записи UCSR0A должны быть нулями.
+ */
+#define TXC_CLEAR()		(UCSR0A = (UCSR0A & (1<<U2X0)) | (1<<TXC0))
+
+static volatile uint8_t owi_shift;	//!< Передаваемые биты, принятые вдвигаются старшим битом.
+static volatile uint8_t owi_bits;	//!< Сколько слотов осталось.
+
+/**
+\brief Настраивает скорость USART0. Внутренняя функция.
+\param ubrr Значение делителя.
+\param u2x 1 -- удвоенная скорость (U2X0).
+\param rx_int 1 -- разрешить прерывание по приему.
+*/
+static void OWI_baud(uint16_t ubrr, uint8_t u2x, uint8_t rx_int)
+{
+	// Дожидаемся, пока последний байт (импульс сброса или слот) полностью
+	// выйдет из сдвигового регистра: UDRE0 освобождается раньше.
+	if(UCSR0B & (1<<TXEN0))
+		while(!(UCSR0A & (1<<TXC0)));
+	UCSR0B = 0;
+	UBRR0H = ubrr >> 8;
+	UBRR0L = ubrr;
+	UCSR0A = u2x ? (1<<U2X0) : 0;
+	UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);	// 8-bit, 1 stop bit, no parity.
+	UCSR0B = (1 << RXEN0) | (1 << TXEN0) | (rx_int ? (1 << RXCIE0) : 0);
+}
+
+/**
+\brief Прерывание по приему: конец очередного слота.
+\details Байт 0xFF вернулся без искажений -- в слоте была "1", любой другой
+-- устройство удерживало линию в нуле.
+*/
+ISR(USART0_RX_vect)
+{
+	uint8_t shift = owi_shift >> 1;
+
+	if(UDR0 == 0xFF) shift |= 0x80;
+	owi_shift = shift;
+	if(--owi_bits)
+	{
+		TXC_CLEAR();
+		UDR0 = (shift & 1) ? 0xFF : 0x00;	// Следующий слот.
+	}
+}
+
+uint8_t OWI_presence(void)
+{
+	uint8_t	echo;
+
+	OWI_baud(OWI_UBRR_RESET, 0, 0);
+	TXC_CLEAR();
+	UDR0 = 0xF0;							// Импульс сброса, затем линия отпущена.
+	while(!(UCSR0A & (1<<RXC0)));			// Ждем эхо (около 1 мс), прерывания разрешены.
+	echo = UDR0;
+	OWI_baud(OWI_UBRR_SLOT, 1, 1);
+	// Импульс присутствия (до 300 мкс после сброса) искажает только
+	// старшие биты эха. Ноль во всех битах -- линия замкнута на землю.
+	if(echo == 0x00) return 0;
+	return (echo != 0xF0);
+}
+
+void OWI_start_byte(uint8_t byte)
+{
+	while(owi_bits);						// Предыдущий обмен должен завершиться.
+	owi_shift = byte;
+	owi_bits = 8;
+	TXC_CLEAR();
+	UDR0 = (byte & 1) ? 0xFF : 0x00;
+}
+
+uint8_t OWI_busy(void)
+{
+	return owi_bits ? 1 : 0;
+}
+
+uint8_t OWI_result(void)
+{
+	return owi_shift;
+}
+
+/**
+\brief Один слот. Внутренняя функция.
+\param bit Передаваемый бит, для чтения -- 1.
+\return Состояние шины в слоте.
+*/
+static uint8_t OWI_slot(uint8_t bit)
+{
+	while(owi_bits);
+	owi_shift = bit ? 1 : 0;
+	owi_bits = 1;
+	TXC_CLEAR();
+	UDR0 = bit ? 0xFF : 0x00;
+	while(owi_bits);
+	return owi_shift >> 7;
+}
+
+void OWI_write_bit(uint8_t bit)
+{
+	OWI_slot(bit);
+}
+
+uint8_t OWI_read_bit(void)
+{
+	return OWI_slot(1);
+}
+
+void OWI_write_byte(uint8_t byte)
+{
+	OWI_start_byte(byte);
+	while(owi_bits);
+}
+
+uint8_t OWI_read_byte(void)
+{
+	OWI_start_byte(0xFF);
+	while(owi_bits);
+	return owi_shift;
+}
+
+#endif
+
+// ========================================================================
+//                 Поиск устройств
+
+uint8_t OWI_search(uint8_t cmd, uint8_t *rom, uint8_t last_discrepancy)
+{
+	uint8_t bit_index, id_bit, cmp_bit, dir;
+	uint8_t byte_index = 0, mask = 1;
+	uint8_t discrepancy = 0;
+
+	if(!OWI_presence()) return OWI_SEARCH_ERROR;
+	OWI_write_byte(cmd);
+
+	for(bit_index = 1; bit_index <= OWI_ROM_SIZE*8; bit_index++)
+	{
+		id_bit = OWI_read_bit();				// Бит адреса.
+		cmp_bit = OWI_read_bit();				// Инверсия бита адреса.
+
+		if(id_bit && cmp_bit)					// Никто не ответил.
+			return OWI_SEARCH_ERROR;
+
+		if(id_bit != cmp_bit) dir = id_bit;		// У всех устройств бит одинаковый.
+		else									// Коллизия.
+		{
+			if(bit_index < last_discrepancy)	// Идем по прежней ветви.
+				dir = (rom[byte_index] & mask) ? 1 : 0;
+			else								// На последней коллизии сворачиваем в "1".
+				dir = (bit_index == last_discrepancy);
+			if(!dir) discrepancy = bit_index;
+		}
+
+		if(dir) rom[byte_index] |= mask;
+		else rom[byte_index] &= ~mask;
+		OWI_write_bit(dir);						// Отключаем устройства другой ветви.
+
+		mask <<= 1;
+		if(!mask)
+		{
+			mask = 1;
+			byte_index++;
+		}
+	}
+	return discrepancy;
+}
+
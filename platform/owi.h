@@ -0,0 +1,121 @@
+/**
+ \file owi.h
+ \author Shauerman Alexander <shamrel@yandex.ru>  www.labfor.ru
+ \brief Библиотека для работы с однопроводным интерфейсом 1-Wire стенда LESO6.
+ \details Библиотека содержит функции нижнего уровня для шины 1-Wire
+ (One Wire Interface -- OWI): сброс, слоты записи и чтения, поиск устройств.
+ Временные слоты формируются программно (задержками на выводе PB4), либо
+ аппаратно -- приемопередатчиком USART0 (см. OWI_USART).
+ \version   0.1
+ \date 4.12.2014
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef OWI_H_
+#define OWI_H_
+
+#include <stdint.h>
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Если OWI_USART определен, то слоты формирует USART0, иначе -- программно.
+ \details USART0 передает байт 0xF0 на скорости 9600 бит/с для сброса и
+ байты 0x00/0xFF на скорости 115200 бит/с для слотов "0" и "1"/чтения.
+ Каждый слот -- одно прерывание по приему, задержки и запрет прерываний
+ не нужны. Шина подключается к RXD0 (PE0) и через диод или ключ с открытым
+ стоком к TXD0 (PE1). На стенде LESO6 эти выводы заняты шиной данных ЖКИ,
+ поэтому по умолчанию используется программная реализация.
+ */
+//#define OWI_USART
+/*************************************************************************/
+
+#define OWI_CMD_SEARCHROM		(0xF0)					//!< Команда поиска устройств на шине.
+#define OWI_CMD_ALARMSEARCH		(0xEC)					//!< Команда поиска устройств в состоянии тревоги.
+#define OWI_CMD_MATCHROM		(0x55)					//!< Команда для доступа к устройству по адресу.
+#define OWI_CMD_SKIPROM			(0xCC)					//!< Команда для доступа ко всем устройствам на шине сразу.
+
+#define OWI_ROM_SIZE			(8)						//!< Размер адреса (ROM) устройства, байт.
+#define OWI_SEARCH_ERROR		(0xFF)					//!< Ошибка при поиске устройств.
+
+/**
+\brief Процедура инициализации -- сброс и проверка наличия устройства.
+\return  1 -- на шине есть устройство;
+\return  0 -- на шине нет устройства или линия замкнута на землю;
+*/
+uint8_t OWI_presence(void);
+
+/**
+\brief Передает один бит (слот записи).
+\param bit 0 -- передать "0", иначе -- "1".
+*/
+void OWI_write_bit(uint8_t bit);
+
+/**
+\brief Принимает один бит (слот чтения).
+\return Состояние шины в слоте чтения.
+*/
+uint8_t OWI_read_bit(void);
+
+/**
+\brief Передает байт, младшим битом вперед.
+\param byte Байт для передачи.
+*/
+void OWI_write_byte(uint8_t byte);
+
+/**
+\brief Принимает байт, младшим битом вперед.
+\return Принятый байт.
+*/
+uint8_t OWI_read_byte(void);
+
+/**
+\brief Один проход алгоритма поиска устройств.
+\details На каждом из 64 битов адреса все устройства выдают бит и его
+инверсию. Если оба равны нулю -- на этом бите расходятся адреса
+нескольких устройств (коллизия). Ветвь выбирается по номеру последней
+коллизии предыдущего прохода, так что за несколько проходов перебирается
+все дерево адресов.
+\param cmd Команда поиска (OWI_CMD_SEARCHROM или OWI_CMD_ALARMSEARCH).
+\param *rom Адрес предыдущего найденного устройства; на выходе -- новый адрес.
+\param last_discrepancy Номер бита последней коллизии предыдущего прохода (0 -- первый проход).
+\return Номер бита последней коллизии текущего прохода; 0 -- найдено последнее
+устройство; OWI_SEARCH_ERROR -- на шине нет устройств или сбой.
+*/
+uint8_t OWI_search(uint8_t cmd, uint8_t *rom, uint8_t last_discrepancy);
+
+#ifdef OWI_USART
+/**
+\brief Запускает обмен байтом в фоне.
+\details Передает байт (для чтения -- 0xFF) и сразу возвращает управление.
+Восемь слотов выполняются в прерывании, процессор в это время свободен.
+\param byte Байт для передачи.
+*/
+void OWI_start_byte(uint8_t byte);
+
+/**
+\brief Проверяет, идет ли обмен байтом.
+\return 1 -- обмен еще идет, 0 -- завершен.
+*/
+uint8_t OWI_busy(void);
+
+/**
+\brief Результат последнего обмена.
+\return Байт, принятый с шины за время OWI_start_byte().
+*/
+uint8_t OWI_result(void);
+#endif
+
+#endif /* OWI_H_ */
@@ -0,0 +1,519 @@
+/**
+ \file rf.c
+ \author agent <agent@local>
+ \brief Драйвер радиоприемопередатчика ATMEGA128RFA1 (TRX24)
+ \details Приемопередатчик большую часть времени находится в RX_ON. Для
+ передачи он переводится в PLL_ON; переход из RX_ON занимает около 1 мкс,
+ но если в этот момент принимается кадр, команда выполнится только после
+ приема. Поэтому переход не ожидается на месте: загрузку кадра и запуск
+ передачи выполняет rf_task(), увидев PLL_ON. Следующие кадры очереди
+ запускаются прямо из прерывания конца передачи -- после него
+ приемопередатчик уже в PLL_ON.
+
+ В расширенном режиме прием идет в RX_AACK_ON, передача -- в TX_ARET_ON:
+ RX_AACK_ON -> PLL_ON -> TX_ARET_ON, переходы также завершает rf_task().
+ Итог передачи (подтверждение, занятый канал) -- в TRAC_STATUS.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "rf.h"
+#if RF_RX_TIMESTAMP
+#include "clock.h"
+#endif
+
+#if RF_RX_BUFFERS > 8
+#error "RF_RX_BUFFERS: не больше 8 (маска свободных буферов -- один байт)"
+#endif
+
+#define TRX_STATUS_MASK		0x1F
+#define STATUS()			(TRX_STATUS & TRX_STATUS_MASK)
+#define FRAME_BUFFER		((uint8_t *)&TRXFBST)		//!< Буфер кадра приемопередатчика.
+#define TRAC_STATUS()		((TRX_STATE >> TRAC_STATUS0) & 0x07)
+
+/**
+ \brief  Коды TRAC_STATUS.
+ */
+#define TRAC_SUCCESS				0
+#define TRAC_SUCCESS_DATA_PENDING	1
+#define TRAC_CHANNEL_ACCESS_FAILURE	3
+#define TRAC_NO_ACK					5
+
+/**
+ \brief  Поле FCF заголовка IEEE 802.15.4.
+ */
+#define FCF_TYPE_DATA		0x0001
+#define FCF_ACK_REQUEST		0x0020
+#define FCF_PANID_COMP		0x0040
+#define FCF_DST_SHORT		0x0800
+#define FCF_SRC_SHORT		0x8000
+
+/**
+ \brief  Состояния драйвера.
+ */
+enum
+{
+	RF_RX = 0,			//!< Прием (RX_ON)
+	RF_PLL_WAIT,		//!< Дана команда PLL_ON, ждем перехода
+	RF_ARET_WAIT,		//!< Дана команда TX_ARET_ON, ждем перехода
+	RF_TX				//!< Идет передача кадра
+};
+
+/**
+ \brief  Кадр в очереди передачи.
+ */
+typedef struct rf_frame
+{
+	uint8_t len;
+	uint8_t data[RF_FRAME_SIZE];
+}rf_frame_t;
+
+volatile rf_stats_t rf_stats;
+
+static volatile uint8_t rf_state;
+
+static rf_frame_t tx_queue[RF_TX_QUEUE_SIZE];
+static volatile uint8_t tx_wr, tx_rd, tx_count;
+
+static rf_rx_frame_t rx_pool[RF_RX_BUFFERS];
+static volatile uint8_t rx_free;				//!< Маска свободных буферов пула.
+static uint8_t rx_ready[RF_RX_BUFFERS];			//!< Очередь принятых: номера буферов.
+static volatile uint8_t rx_wr, rx_rd, rx_count;
+
+static rf_rx_cb_t rx_cb;
+
+static uint8_t rf_mode;
+static uint8_t rx_cmd = CMD_RX_ON;		//!< Команда состояния приема для текущего режима.
+static uint16_t pan_id, short_addr;
+static uint8_t mac_seq;
+
+/**
+\brief Идет ли прием кадра. Внутренняя функция.
+*/
+static uint8_t rxBusy(void)
+{
+	uint8_t st = STATUS();
+
+	return (st == BUSY_RX) || (st == BUSY_RX_AACK);
+}
+
+/**
+\brief Длина заголовка IEEE 802.15.4 принятого кадра. Внутренняя функция.
+\param src Сюда записывается короткий адрес отправителя или RF_BROADCAST.
+\return Длина; 0 -- кадр не данных или заголовок длиннее кадра.
+*/
+static uint8_t macHeaderLen(const uint8_t *frame, uint8_t len, uint16_t *src)
+{
+	uint16_t fcf;
+	uint8_t hl = 3;					// FCF и номер.
+
+	if (len < 3)
+		return 0;
+	fcf = frame[0] | (frame[1] << 8);
+	if ((fcf & 0x0007) != FCF_TYPE_DATA)
+		return 0;
+	switch ((fcf >> 10) & 0x03)		// Адрес получателя.
+	{
+	case 2: hl += 2 + 2; break;
+	case 3: hl += 2 + 8; break;
+	}
+	*src = RF_BROADCAST;
+	switch ((fcf >> 14) & 0x03)		// Адрес отправителя.
+	{
+	case 2: hl += 2; break;
+	case 3: hl += 8; break;
+	default: return (hl <= len) ? hl : 0;
+	}
+	if (!(fcf & FCF_PANID_COMP))
+		hl += 2;
+	if (hl > len)
+		return 0;
+	if (((fcf >> 14) & 0x03) == 2)
+		*src = frame[hl - 2] | (frame[hl - 1] << 8);
+	return hl;
+}
+
+/**
+\brief Загрузить первый кадр очереди и начать передачу. Внутренняя функция.
+\details Приемопередатчик должен быть в PLL_ON.
+*/
+static void txStart(void)
+{
+	rf_frame_t *f = &tx_queue[tx_rd];
+
+	FRAME_BUFFER[0] = f->len + RF_FCS_SIZE;		// PHR: длина с контрольной суммой.
+	memcpy(FRAME_BUFFER + 1, f->data, f->len);
+	TRX_STATE = CMD_TX_START;
+	rf_state = RF_TX;
+}
+
+/**
+\brief Начать переход к передаче, если есть что передавать. Внутренняя функция.
+\details Вызывается с запрещенными прерываниями.
+*/
+static void txKick(void)
+{
+	if ((rf_state == RF_RX) && tx_count)
+	{
+		TRX_STATE = CMD_PLL_ON;
+		rf_state = RF_PLL_WAIT;
+	}
+}
+
+/**
+\brief Конец передачи: следующий кадр или возврат в прием.
+\details В RX_AACK_ON прерывание приходит и после автоматического
+подтверждения принятого кадра. Такой конец передачи не относится к
+очереди: приемопередатчик сам возвращается в прием, а начатый переход к
+передаче (RF_PLL_WAIT, RF_ARET_WAIT) продолжается.
+*/
+ISR(TRX24_TX_END_vect)
+{
+	if (rf_state != RF_TX)		// Отправлено подтверждение, а не кадр очереди.
+		return;
+	if (rf_mode == RF_MODE_EXTENDED)
+	{
+		switch (TRAC_STATUS())
+		{
+		case TRAC_SUCCESS:
+		case TRAC_SUCCESS_DATA_PENDING:
+			rf_stats.tx_ok++; break;
+		case TRAC_CHANNEL_ACCESS_FAILURE:
+			rf_stats.tx_busy++; break;
+		default:
+			rf_stats.tx_noack++; break;
+		}
+	}
+	else
+		rf_stats.tx_ok++;
+	if (++tx_rd == RF_TX_QUEUE_SIZE)
+		tx_rd = 0;
+	--tx_count;
+	if (tx_count)
+		txStart();				// Приемопередатчик уже в PLL_ON (TX_ARET_ON).
+	else
+	{
+		TRX_STATE = rx_cmd;
+		rf_state = RF_RX;
+	}
+}
+
+/**
+\brief Занять свободный буфер пула и скопировать в него принятый кадр.
+Внутренняя функция.
+\details Единственное копирование кадра; дальше буфер передается
+приложению целиком.
+*/
+static void rxStore(void)
+{
+	uint8_t phr, length, hl, i;
+	uint16_t src = RF_BROADCAST;
+	rf_rx_frame_t *f;
+
+	phr = TST_RX_LENGTH;
+	length = phr - RF_FCS_SIZE;
+	hl = 0;
+	if (!(PHY_RSSI & (1<<RX_CRC_VALID)) || (phr < RF_FCS_SIZE))
+	{
+		rf_stats.rx_crc++;
+		return;
+	}
+	if ((rf_mode == RF_MODE_EXTENDED) &&
+		!(hl = macHeaderLen(FRAME_BUFFER, length, &src)))
+		return;					// Не кадр данных (например, команда MAC).
+	if (!rx_free)
+	{
+		rf_stats.rx_dropped++;
+		return;
+	}
+	for (i = 0; !(rx_free & (1 << i)); i++);
+	rx_free &= ~(1 << i);
+	f = &rx_pool[i];
+	memcpy(f->psdu, FRAME_BUFFER, length);
+	f->psdu_len = length;
+	f->data = f->psdu + hl;
+	f->len = length - hl;
+	f->src = src;
+	f->lqi = FRAME_BUFFER[phr];	// LQI записан сразу за кадром.
+	f->rssi = RF_RSSI_BASE + PHY_ED_LEVEL;	// ED измерен по кадру.
+#if RF_RX_TIMESTAMP
+	f->time = clockMicros();
+#else
+	f->time = 0;
+#endif
+	rx_ready[rx_wr] = i;
+	if (++rx_wr == RF_RX_BUFFERS)
+		rx_wr = 0;
+	rx_count++;
+	rf_stats.rx_ok++;
+}
+
+/**
+\brief Кадр принят.
+*/
+ISR(TRX24_RX_END_vect)
+{
+	rxStore();
+	txKick();					// Передача ждала конца приема.
+}
+
+void rf_init(void)
+{
+	uint8_t i, seed;
+
+	cli();
+	TRXPR |= (1<<TRXRST);		// Сбрасываем регистры трансивера и конечный автомат.
+	IRQ_MASK = 0;
+	tx_wr = tx_rd = tx_count = 0;
+	rx_wr = rx_rd = rx_count = 0;
+	rx_free = (uint8_t)((1 << RF_RX_BUFFERS) - 1);
+	memset((void *)&rf_stats, 0, sizeof(rf_stats));
+	TRX_CTRL_1 |= (1<<TX_AUTO_CRC_ON);		// Контрольную сумму добавляет приемопередатчик.
+	rf_mode = RF_MODE_BASIC;
+	rx_cmd = CMD_RX_ON;
+	IRQ_MASK = (1<<RX_END_EN) | (1<<TX_END_EN);
+	TRX_STATE = CMD_RX_ON;
+	rf_state = RF_RX;
+	sei();
+	while (STATUS() != RX_ON);	// Из TRX_OFF -- около 110 мкс, только при инициализации.
+	// В режиме приема биты RND_VALUE (6:5) случайны и обновляются каждую
+	// микросекунду: собираем из них зерно отсрочек CSMA-CA.
+	for (i = 0, seed = 0; i < 4; i++)
+	{
+		_delay_us(1);
+		seed = (seed << 2) | ((PHY_RSSI >> 5) & 0x03);
+	}
+	CSMA_SEED_0 = seed;
+#if RF_RX_TIMESTAMP
+	clockInit();
+#endif
+}
+
+int8_t rf_set_channel(uint8_t channel)
+{
+	if ((channel < RF_CHANNEL_MIN) || (channel > RF_CHANNEL_MAX))
+		return (-1);
+	PHY_CC_CCA = (PHY_CC_CCA & ~0x1F) | (channel << CHANNEL0);
+	return 0;
+}
+
+void rf_set_power(uint8_t power)
+{
+	PHY_TX_PWR = (PHY_TX_PWR & ~0x0F) | ((power & 0x0F) << TX_PWR0);
+}
+
+void rf_set_rx_cb(rf_rx_cb_t cb)
+{
+	rx_cb = cb;
+}
+
+rf_rx_frame_t *rf_receive(void)
+{
+	rf_rx_frame_t *f;
+	uint8_t sreg = SREG;
+
+	if (!rx_count)
+		return NULL;
+	f = &rx_pool[rx_ready[rx_rd]];
+	if (++rx_rd == RF_RX_BUFFERS)
+		rx_rd = 0;
+	cli();
+	rx_count--;
+	SREG = sreg;
+	return f;
+}
+
+void rf_release(rf_rx_frame_t *frame)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	rx_free |= 1 << (frame - rx_pool);
+	SREG = sreg;
+}
+
+int8_t rf_send(const void *data, uint8_t len)
+{
+	uint8_t sreg = SREG;
+
+	if (rf_mode == RF_MODE_EXTENDED)
+		return rf_send_to(RF_BROADCAST, data, len);
+	if (!len || (len > RF_MAX_PAYLOAD))
+		return (-2);
+	cli();
+	if (tx_count == RF_TX_QUEUE_SIZE)
+	{
+		rf_stats.tx_dropped++;
+		SREG = sreg;
+		return (-1);
+	}
+	tx_queue[tx_wr].len = len;
+	memcpy(tx_queue[tx_wr].data, data, len);
+	if (++tx_wr == RF_TX_QUEUE_SIZE)
+		tx_wr = 0;
+	tx_count++;
+	if (!rxBusy())				// Во время приема переход начнет прерывание RX_END.
+		txKick();
+	SREG = sreg;
+	return 0;
+}
+
+int8_t rf_send_to(uint16_t dst, const void *data, uint8_t len)
+{
+	uint8_t sreg = SREG;
+	uint16_t fcf = FCF_TYPE_DATA | FCF_PANID_COMP | FCF_DST_SHORT | FCF_SRC_SHORT;
+	uint8_t *h;
+
+	if (!len || (len > RF_MAX_MAC_PAYLOAD))
+		return (-2);
+	if (dst != RF_BROADCAST)
+		fcf |= FCF_ACK_REQUEST;
+	cli();
+	if (tx_count == RF_TX_QUEUE_SIZE)
+	{
+		rf_stats.tx_dropped++;
+		SREG = sreg;
+		return (-1);
+	}
+	h = tx_queue[tx_wr].data;
+	h[0] = fcf;
+	h[1] = fcf >> 8;
+	h[2] = mac_seq++;
+	h[3] = pan_id;
+	h[4] = pan_id >> 8;
+	h[5] = dst;
+	h[6] = dst >> 8;
+	h[7] = short_addr;
+	h[8] = short_addr >> 8;
+	memcpy(h + RF_MAC_HEADER, data, len);
+	tx_queue[tx_wr].len = len + RF_MAC_HEADER;
+	if (++tx_wr == RF_TX_QUEUE_SIZE)
+		tx_wr = 0;
+	tx_count++;
+	if (!rxBusy())
+		txKick();
+	SREG = sreg;
+	return 0;
+}
+
+/**
+\brief Перевести приемопередатчик в PLL_ON для смены настроек. Внутренняя функция.
+\details Дожидается передачи очереди. Возвращается с запрещенными
+прерываниями; продолжение -- rxRestart().
+\return SREG до запрета прерываний.
+*/
+static uint8_t rxStop(void)
+{
+	uint8_t sreg;
+
+	while (tx_count)				// Дожидаемся передачи очереди.
+		rf_task();
+	sreg = SREG;
+	cli();
+	TRX_STATE = CMD_FORCE_PLL_ON;
+	while (STATUS() != PLL_ON);
+	return sreg;
+}
+
+/**
+\brief Вернуться в прием после rxStop(). Внутренняя функция.
+\param sreg Значение, которое вернула rxStop().
+*/
+static void rxRestart(uint8_t sreg)
+{
+	TRX_STATE = rx_cmd;
+	rf_state = RF_RX;
+	SREG = sreg;
+}
+
+void rf_set_mode(uint8_t mode)
+{
+	uint8_t sreg = rxStop();
+
+	rf_mode = mode;
+	rx_cmd = (mode == RF_MODE_EXTENDED) ? CMD_RX_AACK_ON : CMD_RX_ON;
+	rxRestart(sreg);
+}
+
+void rf_set_rate(uint8_t rate)
+{
+	uint8_t sreg = rxStop();
+
+	TRX_CTRL_2 = (TRX_CTRL_2 & ~0x03) | ((rate & 0x03) << OQPSK_DATA_RATE0);
+	rxRestart(sreg);
+}
+
+void rf_set_address(uint16_t pan, uint16_t addr)
+{
+	pan_id = pan;
+	short_addr = addr;
+	PAN_ID_0 = pan;
+	PAN_ID_1 = pan >> 8;
+	SHORT_ADDR_0 = addr;
+	SHORT_ADDR_1 = addr >> 8;
+	mac_seq = addr;					// Разные узлы начинают с разных номеров.
+}
+
+void rf_set_retries(uint8_t frame_retries, uint8_t csma_retries)
+{
+	XAH_CTRL_0 = ((frame_retries & 0x0F) << MAX_FRAME_RETRIES0) |
+				((csma_retries & 0x07) << MAX_CSMA_RETRIES0);
+}
+
+uint8_t rf_tx_busy(void)
+{
+	return (tx_count != 0);
+}
+
+uint8_t rf_tx_free(void)
+{
+	return RF_TX_QUEUE_SIZE - tx_count;
+}
+
+uint8_t rf_max_payload(void)
+{
+	return (rf_mode == RF_MODE_EXTENDED) ? RF_MAX_MAC_PAYLOAD : RF_MAX_PAYLOAD;
+}
+
+void rf_task(void)
+{
+	rf_rx_frame_t *f;
+	uint8_t sreg = SREG;
+
+	cli();
+	// PLL_ON достигнут, и принятый перед этим кадр уже забран из буфера.
+	if ((rf_state == RF_PLL_WAIT) && (STATUS() == PLL_ON) &&
+		!(IRQ_STATUS & (1<<RX_END)))
+	{
+		if (rf_mode == RF_MODE_EXTENDED)
+		{
+			TRX_STATE = CMD_TX_ARET_ON;
+			rf_state = RF_ARET_WAIT;
+		}
+		else
+			txStart();
+	}
+	if ((rf_state == RF_ARET_WAIT) && (STATUS() == TX_ARET_ON))
+		txStart();
+	SREG = sreg;
+
+	while (rx_cb && (f = rf_receive()))
+		rx_cb(f);
+}
@@ -0,0 +1,271 @@
+/**
+ \file rf.h
+ \author agent <agent@local>
+ \brief Драйвер радиоприемопередатчика ATMEGA128RFA1 (TRX24)
+ \details Драйвер ведет конечный автомат приемопередатчика и не ждет смены
+ состояний в прерываниях. Передаваемые кадры ставятся в очередь и уходят в
+ эфир один за другим.
+
+ Принятые кадры прерывание один раз копирует в свободный буфер из пула
+ (RF_RX_BUFFERS) вместе с LQI, RSSI и временем приема и ставит в очередь.
+ Приложение забирает кадр функцией rf_receive() или получает в функции
+ обратного вызова из rf_task(); с этого момента буфер принадлежит
+ приложению, пока оно не вернет его rf_release(). Пока кадры обрабатываются,
+ следующие принимаются в оставшиеся буферы; если свободных нет, кадр
+ отбрасывается (rf_stats.rx_dropped).
+
+ В расширенном режиме (rf_set_mode(RF_MODE_EXTENDED)) приемопередатчик сам
+ подтверждает принятые кадры (RX_AACK_ON), отбрасывает кадры для чужих
+ PAN и адресов, а при передаче (TX_ARET_ON) выполняет CSMA-CA и повторяет
+ кадр, пока не придет подтверждение. Кадры в этом режиме имеют заголовок
+ IEEE 802.15.4; его формирует rf_send_to(), а функция обратного вызова
+ получает только данные.
+\code{.c}
+	void rx(rf_rx_frame_t *f)
+	{
+		printf("%.*s (%d dBm)\n", f->len, (char *)f->data, f->rssi);
+		rf_release(f);			// Можно и позже, например после обработки.
+	}
+
+	rf_init();
+	rf_set_channel(15);
+	rf_set_rx_cb(rx);
+	sei();
+	rf_send("hello", 5);
+	while (1)
+		rf_task();
+\endcode
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef RF_H_
+#define RF_H_
+
+#include <stdint.h>
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Размер очереди передачи, кадров.
+ */
+#define RF_TX_QUEUE_SIZE	(4)
+
+/**
+ \brief  Количество буферов приема.
+ */
+#define RF_RX_BUFFERS		(4)
+
+/**
+ \brief  Отметка времени принятых кадров.
+ \details 1 -- поле time заполняется clockMicros() (clock.c, таймер 1;
+ rf_init() запускает часы); 0 -- поле равно нулю, clock.c не нужен.
+ */
+#define RF_RX_TIMESTAMP		(1)
+/*************************************************************************/
+
+#define RF_FRAME_SIZE		(127)	//!< Наибольший кадр PHY, байт.
+#define RF_FCS_SIZE			(2)		//!< Контрольная сумма кадра (добавляется автоматически).
+#define RF_MAX_PAYLOAD		(RF_FRAME_SIZE - RF_FCS_SIZE)	//!< Наибольшая длина данных кадра.
+
+#define RF_CHANNEL_MIN		(11)	//!< Каналы 2,4 ГГц: 11..26.
+#define RF_CHANNEL_MAX		(26)
+
+#define RF_MAC_HEADER		(9)		//!< Заголовок кадра rf_send_to(): FCF, номер, PAN, адреса.
+#define RF_MAX_MAC_PAYLOAD	(RF_MAX_PAYLOAD - RF_MAC_HEADER)	//!< Наибольшая длина данных rf_send_to().
+#define RF_BROADCAST		(0xFFFF)	//!< Широковещательный адрес (без подтверждения).
+
+/**
+ \brief  Скорости передачи (OQPSK). Выше 250 кбит/с -- нестандартные режимы
+ приемопередатчика, оба узла должны работать на одной скорости.
+ */
+#define RF_RATE_250K		(0)		//!< 250 кбит/с (IEEE 802.15.4)
+#define RF_RATE_500K		(1)		//!< 500 кбит/с
+#define RF_RATE_1M			(2)		//!< 1 Мбит/с
+#define RF_RATE_2M			(3)		//!< 2 Мбит/с
+
+/**
+ \brief  Режимы работы.
+ */
+#define RF_MODE_BASIC		(0)		//!< Основной: кадры без подтверждений и повторов
+#define RF_MODE_EXTENDED	(1)		//!< Расширенный: подтверждения, повторы, CSMA-CA, фильтр адресов
+
+/**
+ \struct rf_stats_t
+ \brief Счетчики кадров.
+ */
+typedef struct rf_stats
+{
+	uint16_t tx_ok;				//!< Передано кадров
+	uint16_t tx_dropped;		//!< Не принято в очередь передачи (очередь полна)
+	uint16_t tx_noack;			//!< Расширенный режим: нет подтверждения после всех повторов
+	uint16_t tx_busy;			//!< Расширенный режим: канал занят (CSMA-CA не удалось)
+	uint16_t rx_ok;				//!< Принято кадров
+	uint16_t rx_crc;			//!< Отброшено с ошибкой контрольной суммы
+	uint16_t rx_dropped;		//!< Отброшено: нет свободного буфера приема
+}rf_stats_t;
+
+#define RF_RSSI_BASE		(-90)	//!< RSSI при нулевом уровне ED, дБм.
+
+/**
+ \struct rf_rx_frame_t
+ \brief Принятый кадр.
+ \details Буфер пула приема. Поля заполняет прерывание; приложение только
+ читает их и возвращает буфер rf_release().
+ */
+typedef struct rf_rx_frame
+{
+	uint8_t *data;				//!< Данные (в расширенном режиме -- после заголовка)
+	uint8_t len;				//!< Длина данных
+	uint16_t src;				//!< Адрес отправителя; RF_BROADCAST -- неизвестен (основной режим)
+	uint8_t lqi;				//!< Качество связи, 0..255
+	int8_t rssi;				//!< Уровень сигнала кадра, дБм
+	uint32_t time;				//!< Время приема (конец кадра), мкс; см. RF_RX_TIMESTAMP
+	uint8_t psdu_len;			//!< Длина кадра без контрольной суммы
+	uint8_t psdu[RF_FRAME_SIZE];	//!< Кадр целиком
+}rf_rx_frame_t;
+
+/**
+ \brief  Функция обратного вызова для принятого кадра.
+ \details Вызывается из rf_task() в основном цикле. Кадр передается
+ приложению: оно должно вернуть его rf_release(), сразу или позже.
+ */
+typedef void (*rf_rx_cb_t)(rf_rx_frame_t *frame);
+
+/**
+ \brief  Счетчики кадров (только чтение).
+ */
+extern volatile rf_stats_t rf_stats;
+
+/**
+\brief Инициализация приемопередатчика.
+\details Сбрасывает приемопередатчик и включает прием. Для работы нужны
+разрешенные прерывания.
+*/
+void rf_init(void);
+
+/**
+\brief Установить канал.
+\param channel Канал RF_CHANNEL_MIN..RF_CHANNEL_MAX (2405 + 5 * (channel - 11) МГц).
+\return 0 -- успешно; -1 -- нет такого канала.
+*/
+int8_t rf_set_channel(uint8_t channel);
+
+/**
+\brief Установить мощность передатчика.
+\param power Код TX_PWR: 0 -- +3,5 дБм ... 15 -- -16,5 дБм.
+*/
+void rf_set_power(uint8_t power);
+
+/**
+\brief Установить скорость передачи.
+\details Дожидается окончания передачи очереди. Вызывается из основного
+цикла с разрешенными прерываниями, но не из функции обратного вызова приема.
+\param rate RF_RATE_250K .. RF_RATE_2M.
+*/
+void rf_set_rate(uint8_t rate);
+
+/**
+\brief Выбрать режим работы.
+\details Дожидается окончания передачи очереди. Вызывается из основного
+цикла с разрешенными прерываниями, но не из функции обратного вызова приема.
+\param mode RF_MODE_BASIC или RF_MODE_EXTENDED.
+*/
+void rf_set_mode(uint8_t mode);
+
+/**
+\brief Установить адрес узла для расширенного режима.
+\param pan Идентификатор сети (PAN ID).
+\param addr Короткий адрес узла.
+*/
+void rf_set_address(uint16_t pan, uint16_t addr);
+
+/**
+\brief Настроить повторы расширенного режима.
+\param frame_retries Повторов кадра без подтверждения, 0..15 (по умолчанию 3).
+\param csma_retries Повторов CSMA-CA при занятом канале, 0..5 (по умолчанию 4).
+*/
+void rf_set_retries(uint8_t frame_retries, uint8_t csma_retries);
+
+/**
+\brief Установить функцию обратного вызова для принятых кадров.
+\param cb Функция; NULL -- кадры ждут в очереди, их забирает rf_receive().
+*/
+void rf_set_rx_cb(rf_rx_cb_t cb);
+
+/**
+\brief Забрать принятый кадр.
+\details Кадр остается у приложения до вызова rf_release().
+\return Кадр; NULL -- очередь приема пуста.
+*/
+rf_rx_frame_t *rf_receive(void);
+
+/**
+\brief Вернуть буфер кадра в пул приема.
+\details Можно вызывать из прерываний.
+\param frame Кадр, полученный rf_receive() или функцией обратного вызова.
+*/
+void rf_release(rf_rx_frame_t *frame);
+
+/**
+\brief Поставить кадр в очередь передачи.
+\details Данные копируются, функция возвращается сразу. Можно вызывать
+из прерываний.
+\param data Данные кадра.
+\param len Длина, 1..rf_max_payload().
+\return 0 -- кадр в очереди; -1 -- очередь полна; -2 -- неверная длина.
+\note В расширенном режиме кадр отправляется широковещательно (rf_send_to(RF_BROADCAST, ...)).
+*/
+int8_t rf_send(const void *data, uint8_t len);
+
+/**
+\brief Наибольшая длина данных rf_send() в текущем режиме.
+\return RF_MAX_PAYLOAD в основном режиме, RF_MAX_MAC_PAYLOAD в расширенном.
+*/
+uint8_t rf_max_payload(void);
+
+/**
+\brief Поставить в очередь кадр для узла (расширенный режим).
+\details Добавляет заголовок IEEE 802.15.4 (кадр данных, короткие адреса,
+свой PAN). Кадр для конкретного адреса запрашивает подтверждение.
+\param dst Адрес получателя; RF_BROADCAST -- всем.
+\param data Данные.
+\param len Длина, 1..RF_MAX_MAC_PAYLOAD.
+\return 0 -- кадр в очереди; -1 -- очередь полна; -2 -- неверная длина.
+*/
+int8_t rf_send_to(uint16_t dst, const void *data, uint8_t len);
+
+/**
+\brief Есть ли непереданные кадры.
+\return 1 -- передача идет; 0 -- очередь пуста.
+*/
+uint8_t rf_tx_busy(void);
+
+/**
+\brief Свободные места в очереди передачи.
+\return Сколько кадров можно поставить в очередь без отказа.
+*/
+uint8_t rf_tx_free(void);
+
+/**
+\brief Обработка в основном цикле.
+\details Продолжает передачу, когда приемопередатчик переходит в PLL_ON,
+и передает принятые кадры функции обратного вызова (если она установлена).
+Вызывать как можно чаще.
+*/
+void rf_task(void);
+
+#endif /* RF_H_ */
@@ -0,0 +1,430 @@
+/**
+ \file rftp.c
+ \author agent <agent@local>
+ \brief Передача больших сообщений по радиоканалу (фрагментация и сборка)
+ \details Кадры транспорта (первый байт -- тип):
+ - начало: тип, номер передачи, длина сообщения (4 байта);
+ - фрагмент: тип, номер передачи, номер фрагмента (2 байта), данные;
+ - подтверждение: тип, номер передачи, первый недостающий фрагмент
+ (2 байта), карта принятых после него (2 байта, бит i -- фрагмент
+ base + 1 + i).
+
+ Начало передачи подтверждается подтверждением с base = 0. Окно хранится
+ битовыми масками относительно base: бит i -- фрагмент base + i.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "rf.h"
+#include "clock.h"
+#include "rftp.h"
+
+#if (RFTP_WINDOW < 2) || (RFTP_WINDOW > 16)
+#error "RFTP_WINDOW: 2..16 (маски окна -- 16 бит)"
+#endif
+
+#define TYPE_START		0xA1
+#define TYPE_DATA		0xA2
+#define TYPE_ACK		0xA3
+
+#define TIMEOUT_US		((uint32_t)RFTP_TIMEOUT_MS * 1000)
+#define ACK_DELAY_US	((uint32_t)RFTP_ACK_DELAY_MS * 1000)
+#define RX_TIMEOUT_US	((uint32_t)RFTP_RX_TIMEOUT_MS * 1000)
+#define BIT(i)			((uint16_t)1 << (i))
+
+/**
+ \brief  Состояние передачи.
+ */
+static struct
+{
+	uint8_t state;
+	uint8_t id;					//!< Номер передачи.
+	uint8_t started;			//!< Приемник подтвердил начало.
+	const uint8_t *src;
+	rftp_read_cb_t read;
+	uint32_t len;
+	uint16_t nfrags;
+	uint16_t base;				//!< Первый неподтвержденный фрагмент.
+	uint16_t next;				//!< Следующий еще не отправленный.
+	uint16_t acked;				//!< Подтвержденные в окне.
+	uint16_t resend;			//!< Ждут повтора.
+	uint16_t resent;			//!< Уже повторены после последнего тайм-аута.
+	uint8_t retries;
+	uint32_t timer;				//!< Время последней отправки или подтверждения.
+}tx;
+
+/**
+ \brief  Состояние приема.
+ */
+static struct
+{
+	uint8_t state;
+	uint8_t id;
+	uint8_t *buf;
+	uint32_t size;
+	rftp_write_cb_t write;
+	uint32_t len;
+	uint16_t nfrags;
+	uint16_t base;				//!< Первый недостающий фрагмент.
+	uint16_t got;				//!< Принятые в окне.
+	uint8_t unacked;			//!< Принято фрагментов после последнего подтверждения.
+	uint32_t timer;				//!< Время начала или последнего фрагмента.
+}rx;
+
+/**
+\brief Сдвиг маски окна (сдвиг на 16 и больше -- ноль). Внутренняя функция.
+*/
+static uint16_t shift(uint16_t mask, uint16_t n)
+{
+	return (n >= 16) ? 0 : (mask >> n);
+}
+
+/**
+\brief Маска из n младших бит, n = 0..16. Внутренняя функция.
+*/
+static uint16_t lowBits(uint16_t n)
+{
+	return (n >= 16) ? 0xFFFF : (BIT(n) - 1);
+}
+
+/**
+\brief Длина фрагмента. Внутренняя функция.
+*/
+static uint8_t fragLen(uint32_t len, uint16_t seq)
+{
+	uint32_t rest = len - (uint32_t)seq * RFTP_FRAG_SIZE;
+
+	return (rest > RFTP_FRAG_SIZE) ? RFTP_FRAG_SIZE : rest;
+}
+
+/**
+\brief Отправить запрос начала передачи. Внутренняя функция.
+*/
+static void sendStart(void)
+{
+	uint8_t f[6];
+
+	f[0] = TYPE_START;
+	f[1] = tx.id;
+	memcpy(&f[2], &tx.len, 4);
+	rf_send(f, sizeof(f));
+	tx.timer = clockMicros();
+}
+
+/**
+\brief Отправить фрагмент. Внутренняя функция.
+*/
+static void sendFrag(uint16_t seq)
+{
+	uint8_t f[RFTP_HEADER + RFTP_FRAG_SIZE];
+	uint8_t n = fragLen(tx.len, seq);
+	uint32_t off = (uint32_t)seq * RFTP_FRAG_SIZE;
+
+	f[0] = TYPE_DATA;
+	f[1] = tx.id;
+	f[2] = seq;
+	f[3] = seq >> 8;
+	if (tx.src)
+		memcpy(&f[RFTP_HEADER], tx.src + off, n);
+	else
+		tx.read(off, &f[RFTP_HEADER], n);
+	rf_send(f, RFTP_HEADER + n);
+	tx.timer = clockMicros();
+}
+
+/**
+\brief Отправить подтверждение приема. Внутренняя функция.
+*/
+static void sendAck(void)
+{
+	uint8_t f[6];
+	uint16_t map = rx.got >> 1;
+
+	f[0] = TYPE_ACK;
+	f[1] = rx.id;
+	f[2] = rx.base;
+	f[3] = rx.base >> 8;
+	f[4] = map;
+	f[5] = map >> 8;
+	if (rf_send(f, sizeof(f)) == 0)
+		rx.unacked = 0;				// Иначе повторим из rftp_task().
+}
+
+/**
+\brief Общая часть rftp_send() и rftp_send_cb(). Внутренняя функция.
+*/
+static int8_t txBegin(const void *data, rftp_read_cb_t read, uint32_t len)
+{
+	if (tx.state == RFTP_BUSY)
+		return (-1);
+	if (!len || (len > RFTP_MAX_LENGTH))
+		return (-2);
+	tx.src = data;
+	tx.read = read;
+	tx.len = len;
+	tx.nfrags = (len + RFTP_FRAG_SIZE - 1) / RFTP_FRAG_SIZE;
+	tx.id++;
+	tx.started = 0;
+	tx.base = tx.next = 0;
+	tx.acked = tx.resend = tx.resent = 0;
+	tx.retries = 0;
+	tx.state = RFTP_BUSY;
+	sendStart();
+	return 0;
+}
+
+/**
+\brief Подтверждение от приемника. Внутренняя функция.
+*/
+static void txAck(uint16_t base, uint16_t map)
+{
+	uint16_t d, missing;
+	uint8_t i, top;
+
+	if ((tx.state != RFTP_BUSY) || (base < tx.base) || (base > tx.next))
+		return;						// Старое или чужое подтверждение.
+	if (!tx.started)
+	{
+		tx.started = 1;
+		tx.retries = 0;
+		tx.timer = clockMicros();
+		return;
+	}
+	d = base - tx.base;
+	if (d || (map & ~shift(tx.acked, d + 1)))
+	{
+		tx.retries = 0;				// Есть продвижение.
+		tx.timer = clockMicros();
+	}
+	tx.base = base;
+	tx.acked = shift(tx.acked, d) | (map << 1);
+	tx.resend = shift(tx.resend, d);
+	tx.resent = shift(tx.resent, d);
+	if (tx.base == tx.nfrags)
+	{
+		tx.state = RFTP_DONE;
+		return;
+	}
+	// Кадры идут по порядку: все, что отправлено раньше последнего
+	// принятого и не принято, потеряно.
+	for (top = 0, i = 1; i < RFTP_WINDOW; i++)
+		if (tx.acked & BIT(i))
+			top = i;
+	missing = ~tx.acked & lowBits(top) & ~tx.resent;
+	tx.resend |= missing;
+}
+
+/**
+\brief Тайм-аут подтверждения: повторить все неподтвержденное. Внутренняя функция.
+*/
+static void txTimeout(void)
+{
+	if (++tx.retries > RFTP_RETRIES)
+	{
+		tx.state = RFTP_FAILED;
+		return;
+	}
+	if (!tx.started)
+	{
+		sendStart();
+		return;
+	}
+	tx.resend = ~tx.acked & lowBits(tx.next - tx.base);
+	tx.resent = 0;
+	tx.timer = clockMicros();
+}
+
+/**
+\brief Отправка фрагментов, пока есть место в очереди радио. Внутренняя функция.
+*/
+static void txPump(void)
+{
+	uint8_t i;
+
+	while (tx.started && (tx.state == RFTP_BUSY) && rf_tx_free())
+	{
+		if (tx.resend)
+		{
+			for (i = 0; !(tx.resend & BIT(i)); i++);
+			tx.resend &= ~BIT(i);
+			tx.resent |= BIT(i);
+			sendFrag(tx.base + i);
+		}
+		else if ((tx.next < tx.nfrags) && (tx.next - tx.base < RFTP_WINDOW))
+			sendFrag(tx.next++);
+		else
+			break;
+	}
+}
+
+/**
+\brief Запрос начала передачи. Внутренняя функция.
+*/
+static void rxStart(uint8_t id, uint32_t len)
+{
+	if ((rx.state == RFTP_BUSY) && (id == rx.id))
+	{
+		sendAck();					// Наше подтверждение потерялось.
+		return;
+	}
+	if ((rx.state != RFTP_LISTEN) && (rx.state != RFTP_BUSY))
+		return;						// Не ждем или не забрали прошлое.
+	if (!len || (len > RFTP_MAX_LENGTH) || (rx.buf && (len > rx.size)))
+		return;
+	rx.id = id;
+	rx.len = len;
+	rx.nfrags = (len + RFTP_FRAG_SIZE - 1) / RFTP_FRAG_SIZE;
+	rx.base = 0;
+	rx.got = 0;
+	rx.state = RFTP_BUSY;
+	rx.timer = clockMicros();
+	sendAck();
+}
+
+/**
+\brief Принят фрагмент. Внутренняя функция.
+*/
+static void rxData(uint8_t id, uint16_t seq, const uint8_t *data, uint8_t len)
+{
+	uint16_t i = seq - rx.base;
+	uint32_t off = (uint32_t)seq * RFTP_FRAG_SIZE;
+
+	if ((id != rx.id) || !rx.nfrags)
+		return;
+	if (seq < rx.base)
+	{
+		// Повтор: передатчик не получил подтверждение. Отвечаем и после
+		// конца приема, даже если приложение уже ждет новое сообщение.
+		sendAck();
+		return;
+	}
+	if ((rx.state != RFTP_BUSY) || (i >= RFTP_WINDOW) || (seq >= rx.nfrags) || (len != fragLen(rx.len, seq)))
+		return;
+	if (!(rx.got & BIT(i)))
+	{
+		if (rx.buf)
+			memcpy(rx.buf + off, data, len);
+		else if (rx.write)
+			rx.write(off, data, len);
+		rx.got |= BIT(i);
+		while (rx.got & 1)
+		{
+			rx.got >>= 1;
+			rx.base++;
+		}
+	}
+	rx.unacked++;
+	rx.timer = clockMicros();
+	if (rx.base == rx.nfrags)
+	{
+		rx.state = RFTP_DONE;
+		sendAck();
+	}
+	else if (rx.unacked >= RFTP_WINDOW / 2)
+		sendAck();
+}
+
+void rftp_init(void)
+{
+	clockInit();
+	memset(&tx, 0, sizeof(tx));
+	memset(&rx, 0, sizeof(rx));
+}
+
+int8_t rftp_send(const void *data, uint32_t len)
+{
+	return txBegin(data, NULL, len);
+}
+
+int8_t rftp_send_cb(rftp_read_cb_t read, uint32_t len)
+{
+	return txBegin(NULL, read, len);
+}
+
+uint8_t rftp_tx_status(void)
+{
+	return tx.state;
+}
+
+void rftp_listen(void *buf, uint32_t size, rftp_write_cb_t write)
+{
+	rx.buf = buf;
+	rx.size = size;
+	rx.write = write;
+	rx.len = 0;
+	rx.unacked = 0;
+	rx.state = RFTP_LISTEN;
+}
+
+uint8_t rftp_rx_status(void)
+{
+	return rx.state;
+}
+
+uint32_t rftp_rx_length(void)
+{
+	return rx.len;
+}
+
+uint8_t rftp_input(rf_rx_frame_t *frame)
+{
+	const uint8_t *d = frame->data;
+	uint32_t len;
+
+	if (!frame->len)
+		return 0;
+	switch (d[0])
+	{
+	case TYPE_START:
+		if (frame->len != 6)
+			return 0;
+		memcpy(&len, &d[2], 4);
+		rxStart(d[1], len);
+		break;
+	case TYPE_DATA:
+		if (frame->len <= RFTP_HEADER)
+			return 0;
+		rxData(d[1], d[2] | (d[3] << 8), &d[RFTP_HEADER], frame->len - RFTP_HEADER);
+		break;
+	case TYPE_ACK:
+		if (frame->len != 6)
+			return 0;
+		if (d[1] == tx.id)
+			txAck(d[2] | (d[3] << 8), d[4] | (d[5] << 8));
+		break;
+	default:
+		return 0;
+	}
+	rf_release(frame);
+	return 1;
+}
+
+void rftp_task(void)
+{
+	uint32_t now = clockMicros();
+
+	if ((tx.state == RFTP_BUSY) && (now - tx.timer >= TIMEOUT_US))
+		txTimeout();
+	txPump();
+	if ((rx.state == RFTP_BUSY) && (now - rx.timer >= RX_TIMEOUT_US))
+	{
+		rx.state = RFTP_FAILED;		// Передатчик пропал.
+		rx.unacked = 0;
+	}
+	if (rx.unacked && (now - rx.timer >= ACK_DELAY_US))
+		sendAck();
+}
@@ -0,0 +1,206 @@
+/**
+ \file rftp.h
+ \author agent <agent@local>
+ \brief Передача больших сообщений по радиоканалу (фрагментация и сборка)
+ \details Транспорт поверх драйвера rf.h. Сообщение длиной до RFTP_MAX_LENGTH
+ (65535 фрагментов, около 7,3 Мбайт) режется на фрагменты по RFTP_FRAG_SIZE
+ байт с номерами.
+ Передатчик держит в эфире окно из RFTP_WINDOW фрагментов и не ждет
+ подтверждения каждого. Приемник периодически отправляет подтверждение:
+ номер первого недостающего фрагмента и битовую карту принятых за ним.
+ Передатчик повторяет только пропущенные фрагменты, а окно сдвигается,
+ как только приходит начало.
+
+ Приемник не копирует фрагменты в промежуточные буферы: каждый фрагмент
+ один раз записывается по своему смещению -- в буфер в ОЗУ или функцией
+ записи (например, во флеш). Поэтому внутри окна фрагменты могут
+ записываться не по порядку.
+
+ Если фрагменты перестают приходить на RFTP_RX_TIMEOUT_MS, прием
+ прерывается (RFTP_FAILED); ждать следующее сообщение -- снова rftp_listen().
+
+ Кадры транспорта начинаются с байта типа 0xA1..0xA3. Кадры приложения,
+ которые идут по тому же каналу, должны начинаться с другого байта.
+
+ Один узел одновременно может передавать одно сообщение и принимать одно.
+ Рекомендуется расширенный режим радио (rf_set_mode(RF_MODE_EXTENDED)):
+ CSMA-CA не дает подтверждениям приемника столкнуться с кадрами данных.
+\code{.c}
+	static uint8_t image[4096];
+
+	void rx(rf_rx_frame_t *f)
+	{
+		if (!rftp_input(f))		// не кадр транспорта
+			rf_release(f);
+	}
+
+	rf_init();
+	rf_set_rx_cb(rx);
+	rftp_init();
+	rftp_listen(image, sizeof(image), NULL);
+	while (1)
+	{
+		rf_task();
+		rftp_task();
+		if (rftp_rx_status() == RFTP_DONE)
+			...					// image[0 .. rftp_rx_length() - 1]
+	}
+\endcode
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef RFTP_H_
+#define RFTP_H_
+
+#include <stdint.h>
+#include "rf.h"
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Окно: сколько фрагментов передается без подтверждения, 2..16.
+ */
+#define RFTP_WINDOW			(8)
+
+/**
+ \brief  Тайм-аут подтверждения, мс.
+ \details Если за это время нет подтверждения, передатчик повторяет все
+ неподтвержденные фрагменты окна (или запрос начала передачи).
+ */
+#define RFTP_TIMEOUT_MS		(50)
+
+/**
+ \brief  Повторов по тайм-ауту подряд, после которых передача прерывается.
+ */
+#define RFTP_RETRIES		(10)
+
+/**
+ \brief  Задержка подтверждения, мс.
+ \details Приемник подтверждает каждые RFTP_WINDOW / 2 фрагмента, а если
+ фрагменты перестали приходить -- через это время после последнего.
+ */
+#define RFTP_ACK_DELAY_MS	(10)
+
+/**
+ \brief  Тайм-аут приема, мс.
+ \details Если за это время не пришел ни один фрагмент, прием прерывается.
+ Больше времени, за которое передатчик сдается (RFTP_RETRIES тайм-аутов).
+ */
+#define RFTP_RX_TIMEOUT_MS	((RFTP_RETRIES + 2) * RFTP_TIMEOUT_MS)
+/*************************************************************************/
+
+#define RFTP_HEADER			(4)		//!< Заголовок фрагмента: тип, номер передачи, номер фрагмента.
+#define RFTP_FRAG_SIZE		(RF_MAX_MAC_PAYLOAD - RFTP_HEADER)	//!< Данные фрагмента, байт.
+#define RFTP_MAX_LENGTH		(65535UL * RFTP_FRAG_SIZE)		//!< Наибольшая длина сообщения.
+
+/**
+ \brief  Состояния передачи и приема.
+ */
+#define RFTP_IDLE			(0)		//!< Нет передачи / прием не ожидается
+#define RFTP_LISTEN			(1)		//!< Прием: ждем начала сообщения
+#define RFTP_BUSY			(2)		//!< Идет передача или прием
+#define RFTP_DONE			(3)		//!< Сообщение передано и подтверждено / принято целиком
+#define RFTP_FAILED			(4)		//!< Нет подтверждений или фрагментов, прервано
+
+/**
+ \brief  Функция чтения передаваемого сообщения.
+ \param offset Смещение от начала сообщения.
+ \param data Куда прочитать.
+ \param len Длина, не больше RFTP_FRAG_SIZE.
+ */
+typedef void (*rftp_read_cb_t)(uint32_t offset, uint8_t *data, uint8_t len);
+
+/**
+ \brief  Функция записи принятого фрагмента.
+ \details Вызывается один раз для каждого фрагмента; в пределах окна
+ фрагменты могут идти не по порядку.
+ \param offset Смещение от начала сообщения.
+ \param data Данные.
+ \param len Длина, не больше RFTP_FRAG_SIZE.
+ */
+typedef void (*rftp_write_cb_t)(uint32_t offset, const uint8_t *data, uint8_t len);
+
+/**
+\brief Инициализация.
+\details Запускает часы (clock.h) для тайм-аутов. Драйвер радио
+инициализирует приложение.
+*/
+void rftp_init(void);
+
+/**
+\brief Начать передачу сообщения из ОЗУ.
+\details Данные не копируются и не должны меняться до конца передачи.
+\param data Сообщение.
+\param len Длина, 1..RFTP_MAX_LENGTH.
+\return 0 -- передача начата; -1 -- предыдущая еще идет; -2 -- неверная длина.
+*/
+int8_t rftp_send(const void *data, uint32_t len);
+
+/**
+\brief Начать передачу сообщения, читаемого функцией.
+\param read Функция чтения; вызывается из rftp_task(), в том числе
+повторно для пропущенных фрагментов.
+\param len Длина, 1..RFTP_MAX_LENGTH.
+\return 0 -- передача начата; -1 -- предыдущая еще идет; -2 -- неверная длина.
+*/
+int8_t rftp_send_cb(rftp_read_cb_t read, uint32_t len);
+
+/**
+\brief Состояние передачи.
+\return RFTP_IDLE, RFTP_BUSY, RFTP_DONE или RFTP_FAILED.
+*/
+uint8_t rftp_tx_status(void);
+
+/**
+\brief Ждать сообщение.
+\details Прерывает текущий прием. Нужно вызывать снова после каждого
+принятого сообщения.
+\param buf Буфер в ОЗУ; NULL -- фрагменты передаются функции write.
+\param size Размер буфера; более длинные сообщения не принимаются.
+\param write Функция записи, если buf равен NULL.
+*/
+void rftp_listen(void *buf, uint32_t size, rftp_write_cb_t write);
+
+/**
+\brief Состояние приема.
+\return RFTP_IDLE, RFTP_LISTEN, RFTP_BUSY, RFTP_DONE или RFTP_FAILED.
+*/
+uint8_t rftp_rx_status(void);
+
+/**
+\brief Длина принимаемого (принятого) сообщения.
+\return Длина, байт; 0 -- прием не начат.
+*/
+uint32_t rftp_rx_length(void);
+
+/**
+\brief Передать принятый кадр транспорту.
+\details Вызывается из функции обратного вызова драйвера радио.
+\param frame Принятый кадр.
+\return 1 -- кадр транспорта, буфер уже возвращен rf_release();
+0 -- чужой кадр, остается у приложения.
+*/
+uint8_t rftp_input(rf_rx_frame_t *frame);
+
+/**
+\brief Обработка в основном цикле.
+\details Отправляет фрагменты и подтверждения, следит за тайм-аутами.
+Вызывать как можно чаще, вместе с rf_task().
+*/
+void rftp_task(void);
+
+#endif /* RFTP_H_ */
@@ -0,0 +1,216 @@
+/**
+ \file sound.c
+ \author agent <agent@local>
+ \brief Звуковые сигналы и мелодии на пьезоизлучателе стенда LESO6
+ \details Тон -- таймер SOUND_TIMER в режиме CTC, длительности -- программный
+ таймер.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "timer.h"
+#include "timer_claim.h"
+#include "swtimer.h"
+#include "sound.h"
+
+#if SOUND_TIMER != 1 && SOUND_TIMER != 3 && SOUND_TIMER != 4 && SOUND_TIMER != 5
+#error "SOUND_TIMER must be 1, 3, 4 or 5"
+#endif
+
+/**
+ \brief  Имена регистров и битов выбранного таймера.
+ */
+#define CAT_(a, n, b)	a##n##b
+#define CAT(a, n, b)	CAT_(a, n, b)
+#define TCCRA		CAT(TCCR, SOUND_TIMER, A)
+#define TCCRB		CAT(TCCR, SOUND_TIMER, B)
+#define TCNT		CAT(TCNT, SOUND_TIMER, )
+#define OCRA		CAT(OCR, SOUND_TIMER, A)
+#define TIMSK		CAT(TIMSK, SOUND_TIMER, )
+#define OCIEA		CAT(OCIE, SOUND_TIMER, A)
+#define WGM2		CAT(WGM, SOUND_TIMER, 2)
+#define CS1			CAT(CS, SOUND_TIMER, 1)
+#define COMA0		CAT(COM, SOUND_TIMER, A0)
+#define COMPA_vect	CAT(TIMER, SOUND_TIMER, _COMPA_vect)
+
+#if SOUND_USE_OC
+/**
+ \brief  Вывод OCnA выбранного таймера.
+ */
+#if SOUND_TIMER == 1
+#define OC_DDR		DDRB
+#define OC_PORT		PORTB
+#define OC_BIT		5
+#elif SOUND_TIMER == 3
+#define OC_DDR		DDRE
+#define OC_PORT		PORTE
+#define OC_BIT		3
+#else
+#error "SOUND_USE_OC: timers 4 and 5 have no OCnA pin on ATmega128RFA1"
+#endif
+#endif
+
+#define SOUND_CLK	(F_CPU / 8)		//!< Таймер тактируется от F_CPU/8.
+
+static const sound_note_t *melody_ptr;	//!< Следующая нота; NULL -- мелодии нет.
+static volatile uint8_t busy;
+static uint8_t claimed;					//!< Таймер занят нами.
+
+TIMER_CLAIM_STATIC(SOUND_TIMER, A)		// Таймер занят целиком, как и в soundInit().
+TIMER_CLAIM_STATIC(SOUND_TIMER, B)
+TIMER_CLAIM_STATIC(SOUND_TIMER, C)
+TIMER_CLAIM_STATIC(SOUND_TIMER, CAPT)
+TIMER_CLAIM_STATIC(SOUND_TIMER, OVF)
+
+static void noteEnd(void *arg);
+static swtimer_t note_timer = SWTIMER_INIT(noteEnd, NULL);
+
+#if !SOUND_USE_OC
+/**
+\brief Полпериода тона: переключаем вывод.
+\details sbi не меняет SREG и регистры, поэтому пролог не нужен.
+*/
+ISR(COMPA_vect, ISR_NAKED)
+{
+	__asm__ __volatile__ (
+		"sbi %0, %1"	"\n\t"
+		"reti"
+		:: "I" (_SFR_IO_ADDR(SOUND_PIN)), "I" (SOUND_BIT));
+}
+#endif
+
+int8_t soundInit(void)
+{
+	int8_t r;
+
+	if (!claimed)
+	{
+		r = timerClaim(SOUND_TIMER, TIMER_ALL_INT, CLK_DIV_8, CTC_MODE, "sound");
+		if (r < 0)
+			return r;
+		claimed = 1;
+	}
+	TIMSK = 0;
+	TCCRA = 0;
+	TCCRB = 1 << WGM2;				// CTC, TOP = OCRnA, таймер остановлен.
+#if SOUND_USE_OC
+	OC_PORT &= ~(1 << OC_BIT);		// Без COMnA0 вывод держит низкий уровень.
+	OC_DDR |= 1 << OC_BIT;
+#else
+	SOUND_DDR |= 1 << SOUND_BIT;
+	SOUND_PORT &= ~(1 << SOUND_BIT);
+#endif
+	melody_ptr = NULL;
+	busy = 0;
+	return 0;
+}
+
+void soundTone(uint16_t freq)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	if (!freq)
+	{
+		TCCRB &= ~CSx_BITS;
+#if SOUND_USE_OC
+		TCCRA &= ~(1 << COMA0);		// Вывод отключен от таймера: низкий уровень из OC_PORT.
+#else
+		TIMSK &= ~(1 << OCIEA);
+		SOUND_PORT &= ~(1 << SOUND_BIT);	// Не держим ток через излучатель.
+#endif
+		SREG = sreg;
+		return;
+	}
+	OCRA = SOUND_CLK / 2 / freq - 1;
+	if (TCNT > OCRA)			// Новый TOP меньше счетчика -- не ждем переполнения.
+		TCNT = 0;
+#if SOUND_USE_OC
+	TCCRA |= 1 << COMA0;		// Переключение OCnA при совпадении.
+#else
+	TIMSK |= 1 << OCIEA;
+#endif
+	TCCRB |= 1 << CS1;			// F_CPU/8.
+	SREG = sreg;
+}
+
+/**
+\brief Конец ноты: следующая нота мелодии или тишина. Внутренняя функция.
+\details Вызывается программным таймером в прерывании.
+*/
+static void noteEnd(void *arg)
+{
+	uint16_t freq, duration;
+
+	if (melody_ptr)
+	{
+		freq = pgm_read_word(&melody_ptr->freq);
+		duration = pgm_read_word(&melody_ptr->duration);
+		if (duration)
+		{
+			melody_ptr++;
+			soundTone(freq);
+			swtimerStart(&note_timer, duration, 0);
+			return;
+		}
+		melody_ptr = NULL;
+	}
+	soundTone(0);
+	busy = 0;
+}
+
+void soundBeep(uint16_t freq, uint16_t ms)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	melody_ptr = NULL;
+	busy = 1;
+	soundTone(freq);
+	swtimerStart(&note_timer, ms, 0);
+	SREG = sreg;
+}
+
+void soundPlay(const sound_note_t *melody)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	melody_ptr = melody;
+	busy = 1;
+	noteEnd(NULL);			// Первая нота.
+	SREG = sreg;
+}
+
+void soundStop(void)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	swtimerStop(&note_timer);
+	melody_ptr = NULL;
+	soundTone(0);
+	busy = 0;
+	SREG = sreg;
+}
+
+uint8_t soundBusy(void)
+{
+	return busy;
+}
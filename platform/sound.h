@@ -0,0 +1,146 @@
+/**
+ \file sound.h
+ \author agent <agent@local>
+ \brief Звуковые сигналы и мелодии на пьезоизлучателе стенда LESO6
+ \details Тон формирует таймер SOUND_TIMER в режиме CTC: канал сравнения A
+ переключает вывод излучателя каждые полпериода. На LESO6 излучатель
+ подключен к PB0, который не является выходом компаратора, поэтому вывод
+ переключает короткое прерывание (одна команда sbi PINB). Если излучатель
+ подключен к выводу OCnA таймера, SOUND_USE_OC переключает его аппаратно,
+ без прерываний.
+
+ Длительности нот отсчитывают программные таймеры (swtimer.h): все функции
+ возвращаются сразу, звук идет в фоне.
+\code{.c}
+	const sound_note_t PROGMEM tune[] = {
+		{ NOTE_C5, 150 }, { NOTE_E5, 150 }, { NOTE_G5, 150 },
+		{ 0, 100 },							// пауза
+		{ NOTE_C6, 300 },
+		{ 0, 0 }							// конец мелодии
+	};
+
+	swtimerInit();
+	soundInit();
+	sei();
+	soundPlay(tune);
+	...
+	soundBeep(1000, 200);
+\endcode
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef SOUND_H_
+#define SOUND_H_
+
+#include <stdint.h>
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Номер 16-битного таймера: 1, 3, 4 или 5.
+ */
+#define SOUND_TIMER		4
+
+/**
+ \brief  Переключать вывод аппаратно (COMnA0, вывод OCnA таймера).
+ \details Только для таймеров 1 (OC1A -- PB5) и 3 (OC3A -- PE3): у таймеров
+ 4 и 5 ATmega128RFA1 нет выводов. soundInit() делает вывод OCnA выходом
+ с низким уровнем.
+ 0 -- излучатель на SOUND_PIN, переключается в прерывании.
+ */
+#define SOUND_USE_OC	0
+
+/**
+ \brief  Вывод излучателя (при SOUND_USE_OC = 0).
+ \details Регистр PINx: запись 1 в бит PINx переключает вывод.
+ */
+#define SOUND_PIN		PINB
+#define SOUND_DDR		DDRB
+#define SOUND_PORT		PORTB
+#define SOUND_BIT		0
+/*************************************************************************/
+
+/**
+ \brief  Частоты нот, Гц.
+ */
+#define NOTE_C4		262
+#define NOTE_D4		294
+#define NOTE_E4		330
+#define NOTE_F4		349
+#define NOTE_G4		392
+#define NOTE_A4		440
+#define NOTE_B4		494
+#define NOTE_C5		523
+#define NOTE_D5		587
+#define NOTE_E5		659
+#define NOTE_F5		698
+#define NOTE_G5		784
+#define NOTE_A5		880
+#define NOTE_B5		988
+#define NOTE_C6		1047
+
+/**
+ \struct sound_note_t
+ \brief Нота мелодии.
+ */
+typedef struct sound_note
+{
+	uint16_t freq;				//!< Частота, Гц; 0 -- пауза
+	uint16_t duration;			//!< Длительность, мс; 0 -- конец мелодии
+}sound_note_t;
+
+/**
+\brief Инициализация.
+\details Занимает таймер SOUND_TIMER целиком (режим CTC меняет TOP, см.
+timer_claim.h) и настраивает вывод излучателя. Нужна запущенная служба
+программных таймеров (swtimerInit()).
+\return 0 -- успешно; меньше нуля -- таймер занят (код timerClaim()).
+*/
+int8_t soundInit(void);
+
+/**
+\brief Включить непрерывный тон.
+\param freq Частота, Гц (16..20000); 0 -- выключить, на выводе низкий уровень.
+*/
+void soundTone(uint16_t freq);
+
+/**
+\brief Звуковой сигнал заданной длительности.
+\details Прерывает мелодию, если она играет.
+\param freq Частота, Гц.
+\param ms Длительность, мс.
+*/
+void soundBeep(uint16_t freq, uint16_t ms);
+
+/**
+\brief Проиграть мелодию.
+\param melody Массив нот во флеш-памяти (PROGMEM), последняя -- с duration = 0.
+*/
+void soundPlay(const sound_note_t *melody);
+
+/**
+\brief Остановить звук.
+*/
+void soundStop(void);
+
+/**
+\brief Звучит ли сигнал или мелодия.
+\return 1 -- да; 0 -- нет.
+*/
+uint8_t soundBusy(void);
+
+#endif /* SOUND_H_ */
@@ -0,0 +1,240 @@
+/**
+ \file swtimer.c
+ \author agent <agent@local>
+ \brief Программные таймеры на одном канале аппаратного таймера
+ \details Хешированное колесо таймеров на канале сравнения A таймера 5.
+ Таймер 5 считает непрерывно; в OCR5A записывается отсчет ближайшей
+ занятой ячейки колеса.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "timer.h"
+#include "timer_claim.h"
+#include "swtimer.h"
+
+#define SLOT_MASK	(SWTIMER_SLOTS - 1)
+#define TICK_CNT	((uint16_t)(F_CPU / 64 / (1000000UL / SWTIMER_TICK_US)))	//!< Отсчетов таймера 5 на такт.
+
+#if SWTIMER_SLOTS > 16 || (SWTIMER_SLOTS & SLOT_MASK)
+#error "SWTIMER_SLOTS must be a power of two not greater than 16"
+#endif
+
+static swtimer_t *wheel[SWTIMER_SLOTS];		//!< Списки таймеров по ячейкам.
+static uint16_t busy;						//!< Битовая карта непустых ячеек.
+static uint16_t now;						//!< Последний обработанный такт.
+static uint16_t base;						//!< Отсчет TCNT5, соответствующий такту now.
+static uint16_t wake;						//!< Такт, на который настроен OCR5A.
+static uint8_t armed;						//!< Прерывание сравнения разрешено.
+static uint8_t claimed;						//!< Канал A таймера 5 занят нами.
+
+TIMER_CLAIM_STATIC(5, A)
+
+/**
+\brief Добавить таймер в ячейку его такта срабатывания. Внутренняя функция.
+*/
+static void link(swtimer_t *t)
+{
+	uint8_t s = t->expire & SLOT_MASK;
+
+	t->slot = s;
+	t->prev = NULL;
+	t->next = wheel[s];
+	if (t->next)
+		t->next->prev = t;
+	wheel[s] = t;
+	busy |= 1 << s;
+}
+
+/**
+\brief Удалить таймер из колеса. Внутренняя функция.
+*/
+static void unlink(swtimer_t *t)
+{
+	if (t->prev)
+		t->prev->next = t->next;
+	else
+	{
+		wheel[t->slot] = t->next;
+		if (!t->next)
+			busy &= ~(1 << t->slot);
+	}
+	if (t->next)
+		t->next->prev = t->prev;
+	t->slot = SWTIMER_IDLE;
+}
+
+/**
+\brief Через сколько тактов ближайшая непустая ячейка. Внутренняя функция.
+\return 1..SWTIMER_SLOTS; 0 -- колесо пусто.
+*/
+static uint8_t nextSlot(void)
+{
+	uint8_t d, s;
+
+	if (!busy)
+		return 0;
+	s = now;
+	for (d = 1; d <= SWTIMER_SLOTS; d++)
+		if (busy & (1 << (++s & SLOT_MASK)))
+			break;
+	return d;
+}
+
+/**
+\brief Переводит now на текущий такт, не перескакивая через wake. Внутренняя функция.
+\details Ячейки между now и wake пусты, поэтому сдвиг ничего не пропускает.
+*/
+static void sync(void)
+{
+	uint16_t elapsed, span = wake - now;
+
+	if (!armed)			// Колесо пусто: время стоит, просто берем новую точку отсчета.
+	{
+		base = TCNT5;
+		return;
+	}
+	if (!span)			// Вызов из обработчика прерывания: now уже равно wake.
+		return;
+	elapsed = (uint16_t)(TCNT5 - base) / TICK_CNT;
+	if (elapsed >= span)
+		elapsed = span - 1;
+	now += elapsed;
+	base += elapsed * TICK_CNT;
+}
+
+/**
+\brief Настраивает OCR5A на ближайшую непустую ячейку. Внутренняя функция.
+*/
+static void schedule(void)
+{
+	uint8_t d = nextSlot();
+
+	if (!d)
+	{
+		TIMSK5 &= ~(1 << OCIE5A);
+		armed = 0;
+		return;
+	}
+	wake = now + d;
+	OCR5A = base + d * TICK_CNT;
+	if (!armed)
+	{
+		TIFR5 = 1 << OCF5A;
+		TIMSK5 |= 1 << OCIE5A;
+		armed = 1;
+	}
+}
+
+int8_t swtimerInit(void)
+{
+	uint8_t i;
+	int8_t r;
+	swtimer_t *t;
+
+	TIMSK5 &= ~(1 << OCIE5A);
+	for (i = 0; i < SWTIMER_SLOTS; i++)
+	{
+		for (t = wheel[i]; t; t = t->next)	// Запущенные таймеры остановлены:
+			t->slot = SWTIMER_IDLE;			// swtimerStart() не станет их отцеплять.
+		wheel[i] = NULL;
+	}
+	busy = 0;
+	armed = 0;
+	if (claimed)
+		return 0;
+	r = timerClaim(5, TIMER_COMPARE_A_INT, CLK_DIV_64, NORMAL_MODE, "swtimer");
+	if (r < 0)
+		return r;
+	claimed = 1;
+	if (r == TIMER_CLAIM_FIRST)
+	{
+		TCCR5A = 0;
+		TCCR5B = (1 << CS51) | (1 << CS50);	// Нормальный режим, F_CPU/64.
+	}
+	return 0;
+}
+
+void swtimerStart(swtimer_t *t, uint16_t delay, uint16_t period)
+{
+	uint8_t sreg = SREG;
+
+	if (!delay)
+		delay = 1;
+	cli();
+	if (t->slot != SWTIMER_IDLE)
+		unlink(t);
+	sync();
+	t->period = period;
+	t->expire = now + delay;
+	link(t);
+	schedule();
+	SREG = sreg;
+}
+
+void swtimerStop(swtimer_t *t)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	if (t->slot != SWTIMER_IDLE)
+	{
+		unlink(t);
+		if (!busy)
+			schedule();		// Последний таймер: запрещаем прерывание.
+	}
+	SREG = sreg;
+}
+
+/**
+\brief Прерывание канала A таймера 5: наступил такт wake.
+\details Вызываем истекшие таймеры ячейки, периодические ставим обратно.
+Если обработка затянулась и следующий такт уже прошел, обрабатываем его
+сразу, не дожидаясь переполнения счетчика.
+*/
+ISR(TIMER5_COMPA_vect)
+{
+	swtimer_t *t;
+	uint8_t s;
+
+	do
+	{
+		TIFR5 = 1 << OCF5A;		// Такт обрабатываем здесь, повторное прерывание не нужно.
+		base += (uint16_t)(wake - now) * TICK_CNT;
+		now = wake;
+		s = now & SLOT_MASK;
+		t = wheel[s];
+		while (t)
+		{
+			if ((int16_t)(t->expire - now) > 0)		// Еще не время (дальний таймер).
+			{
+				t = t->next;
+				continue;
+			}
+			unlink(t);
+			if (t->period)
+			{
+				t->expire += t->period;
+				link(t);
+			}
+			t->cb(t->arg);		// Может менять колесо -- просматриваем ячейку заново.
+			t = wheel[s];
+		}
+		schedule();
+	} while (armed && (int16_t)(OCR5A - TCNT5) <= 0);
+}
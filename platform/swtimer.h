@@ -0,0 +1,126 @@
+/**
+ \file swtimer.h
+ \author agent <agent@local>
+ \brief Программные таймеры на одном канале аппаратного таймера
+ \details Любое количество программных таймеров (однократных и периодических)
+ обслуживается одним каналом сравнения A таймера 5. Таймеры хранятся в
+ хешированном колесе из SWTIMER_SLOTS ячеек: таймер со временем срабатывания
+ T лежит в ячейке T % SWTIMER_SLOTS, поэтому запуск и остановка занимают
+ постоянное время. Прерывание приходит не каждый такт, а только в ближайшую
+ занятую ячейку; если таймеров нет, прерывания сравнения запрещены.
+
+ Функция обратного вызова выполняется в прерывании (с запрещенными
+ прерываниями) и должна быть короткой. Из нее можно запускать и
+ останавливать таймеры, в том числе свой.
+\code{.c}
+	void led_cb(void *arg) { tg(LED0); }
+	swtimer_t led = SWTIMER_INIT(led_cb, NULL);
+
+	swtimerInit();
+	sei();
+	swtimerStart(&led, 500, 500);		// мигать раз в 500 мс
+\endcode
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef SWTIMER_H_
+#define SWTIMER_H_
+
+#include <stdint.h>
+
+/*************************************************************************/
+/**
+ Настройка модуля
+ */
+
+/**
+ \brief  Количество ячеек колеса (степень двойки).
+ \details Таймер с задержкой больше SWTIMER_SLOTS тактов проверяется раз в
+ SWTIMER_SLOTS тактов, пока не подойдет его время.
+ */
+#define SWTIMER_SLOTS		(16)
+
+/**
+ \brief  Длительность такта, мкс.
+ \details Таймер 5 тактируется от F_CPU/64; при F_CPU = 16 МГц такт 1 мс --
+ это 250 отсчетов.
+ */
+#define SWTIMER_TICK_US		(1000)
+/*************************************************************************/
+
+/**
+ \brief  Функция обратного вызова таймера.
+ */
+typedef void (*swtimer_cb_t)(void *arg);
+
+/**
+ \struct swtimer_t
+ \brief Программный таймер.
+ \details Память под таймер выделяет приложение; таймер не должен
+ освобождаться, пока он запущен.
+ */
+typedef struct swtimer
+{
+	struct swtimer *next, *prev;	//!< Соседи в ячейке колеса (внутреннее)
+	uint16_t expire;				//!< Такт срабатывания (внутреннее)
+	uint16_t period;				//!< Период, тактов; 0 -- однократный
+	uint8_t slot;					//!< Ячейка колеса; SWTIMER_IDLE -- не запущен (внутреннее)
+	swtimer_cb_t cb;				//!< Функция обратного вызова
+	void *arg;						//!< Аргумент функции обратного вызова
+}swtimer_t;
+
+#define SWTIMER_IDLE	0xFF		//!< Таймер не запущен.
+
+/**
+ \brief  Инициализатор таймера.
+ */
+#define SWTIMER_INIT(cb, arg)	{ 0, 0, 0, 0, SWTIMER_IDLE, (cb), (arg) }
+
+/**
+\brief Запуск службы таймеров.
+\details Занимает канал A таймера 5 (нормальный режим, F_CPU/64, см.
+timer_claim.h). Для работы нужны разрешенные прерывания. Повторный вызов
+останавливает все запущенные таймеры.
+\return 0 -- успешно; меньше нуля -- таймер 5 занят несовместимо (код timerClaim()).
+*/
+int8_t swtimerInit(void);
+
+/**
+\brief Запуск таймера.
+\details Если таймер уже запущен, он перезапускается с новыми параметрами.
+\param t Указатель на таймер.
+\param delay Задержка до первого срабатывания, тактов (1..32767).
+\param period Период повторения, тактов; 0 -- однократный таймер.
+*/
+void swtimerStart(swtimer_t *t, uint16_t delay, uint16_t period);
+
+/**
+\brief Остановка таймера.
+\details Остановленный таймер не сработает. Остановка не запущенного
+таймера ничего не делает.
+\param t Указатель на таймер.
+*/
+void swtimerStop(swtimer_t *t);
+
+/**
+\brief Запущен ли таймер.
+\param t Указатель на таймер.
+\return 1 -- запущен; 0 -- нет.
+*/
+static inline uint8_t swtimerActive(const swtimer_t *t)
+{
+	return (t->slot != SWTIMER_IDLE);
+}
+
+#endif /* SWTIMER_H_ */
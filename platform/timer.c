@@ -18,8 +18,32 @@ the source code.
 */
 
 #include "timer.h"
+#include "timer_claim.h"
 #include <avr/io.h>
 
+static uint8_t claimed;		//!< Бит n: таймер n занят объектом timer_n.
+
+/**
+\brief Объект timer_N занимает таймер целиком (см. timer_claim.h).
+\details Регистры настраивает приложение, поэтому предделитель и режим
+не важны: совпадающих каналов с другими модулями быть не может.
+Повторный вызов для уже занятого объектом таймера успешен.
+\return 0 -- таймер наш; меньше нуля -- занят другим модулем (код timerClaim()).
+*/
+static int8_t claim(uint8_t n, const char *owner)
+{
+	int8_t r;
+
+	if (claimed & (1 << n))
+		return 0;
+	r = timerClaim(n, TIMER_ALL_INT, CLK_DIV_1, NORMAL_MODE, owner);
+	if (r < 0)
+		return r;
+	claimed |= 1 << n;
+	return 0;
+}
+#define CLAIM(n)	claim(n, "timer_" #n)
+
 #if USE_TIMER_0
 
 void start_timer_0(CLOCK_t clk);
@@ -34,7 +58,7 @@ void timer0PWM_B(PORT_MODE_t mode);
 void timer0PWM_A(PORT_MODE_t mode);
 #endif
 void setCNT_Timer0(uint8_t cnt);
-void clear_reg_0();
+int8_t clear_reg_0();
 
 Timer0_obj timer_0 = {
 	start_timer_0,
@@ -133,12 +157,17 @@ void setCNT_Timer0(uint8_t cnt)
 	TCNT0 = cnt;
 }
 
-void clear_reg_0()
+int8_t clear_reg_0()
 {
+	int8_t r = CLAIM(0);
+
+	if (r < 0)
+		return r;				// Таймер чужой: регистры не трогаем.
 	TCNT0 = 0;
 	TCCR0A = 0;
 	TCCR0B = 0;
 	TIMSK0 = 0;
+	return 0;
 }
 
 #endif
@@ -158,7 +187,7 @@ void timer1PWM_B(PORT_MODE_t mode);
 void timer1PWM_A(PORT_MODE_t mode);
 #endif
 void setCNT_Timer1(uint16_t cnt);
-void clear_reg_1();
+int8_t clear_reg_1();
 
 Timer1_obj timer_1 = {
 	start_timer_1,
@@ -280,12 +309,17 @@ void setCNT_Timer1(uint16_t cnt)
 	TCNT1 = cnt;
 }
 
-void clear_reg_1()
+int8_t clear_reg_1()
 {
+	int8_t r = CLAIM(1);
+
+	if (r < 0)
+		return r;				// Таймер чужой: регистры не трогаем.
 	TCNT1 = 0;
 	TCCR1A = 0;
 	TCCR1B = 0;
 	TIMSK1 = 0;
+	return 0;
 }
 
 #endif
@@ -305,7 +339,7 @@ void timer2PWM_A(PORT_MODE_t mode);
 void async_mode_on();
 void async_mode_off();
 void setCNT_Timer2(uint8_t cnt);
-void clear_reg_2();
+int8_t clear_reg_2();
 
 Timer2_obj timer_2 = {
 	start_timer_2,
@@ -409,12 +443,17 @@ void setCNT_Timer2(uint8_t cnt)
 	TCNT2 = cnt;
 }
 
-void clear_reg_2()
+int8_t clear_reg_2()
 {
+	int8_t r = CLAIM(2);
+
+	if (r < 0)
+		return r;				// Таймер чужой: регистры не трогаем.
 	TCNT2 = 0;
 	TCCR2A = 0;
 	TCCR2B = 0;
 	TIMSK2 = 0;
+	return 0;
 }
 
 #endif
@@ -434,7 +473,7 @@ void timer3PWM_B(PORT_MODE_t mode);
 void timer3PWM_A(PORT_MODE_t mode);
 #endif
 void setCNT_Timer3(uint16_t cnt);
-void clear_reg_3();
+int8_t clear_reg_3();
 
 Timer1_obj timer_3 = {
 	start_timer_3,
@@ -557,12 +596,17 @@ void setCNT_Timer3(uint16_t cnt)
 	TCNT3 = cnt;
 }
 
-void clear_reg_3()
+int8_t clear_reg_3()
 {
+	int8_t r = CLAIM(3);
+
+	if (r < 0)
+		return r;				// Таймер чужой: регистры не трогаем.
 	TCNT3 = 0;
 	TCCR3A = 0;
 	TCCR3B = 0;
 	TIMSK3 = 0;
+	return 0;
 }
 
 #endif
@@ -582,7 +626,7 @@ void timer4PWM_B(PORT_MODE_t mode);
 void timer4PWM_A(PORT_MODE_t mode);
 #endif
 void setCNT_Timer4(uint16_t cnt);
-void clear_reg_4();
+int8_t clear_reg_4();
 
 Timer1_obj timer_4 = {
 	start_timer_4,
@@ -704,12 +748,17 @@ void setCNT_Timer4(uint16_t cnt)
 	TCNT4 = cnt;
 }
 
-void clear_reg_4()
+int8_t clear_reg_4()
 {
+	int8_t r = CLAIM(4);
+
+	if (r < 0)
+		return r;				// Таймер чужой: регистры не трогаем.
 	TCNT4 = 0;
 	TCCR4A = 0;
 	TCCR4B = 0;
 	TIMSK4 = 0;
+	return 0;
 }
 
 #endif
@@ -729,7 +778,7 @@ void timer5PWM_B(PORT_MODE_t mode);
 void timer5PWM_A(PORT_MODE_t mode);
 #endif
 void setCNT_Timer5(uint16_t cnt);
-void clear_reg_5();
+int8_t clear_reg_5();
 
 Timer1_obj timer_5 = {
 	start_timer_5,
@@ -851,12 +900,17 @@ void setCNT_Timer5(uint16_t cnt)
 	TCNT5 = cnt;
 }
 
-void clear_reg_5()
+int8_t clear_reg_5()
 {
+	int8_t r = CLAIM(5);
+
+	if (r < 0)
+		return r;				// Таймер чужой: регистры не трогаем.
 	TCNT5 = 0;
 	TCCR5A = 0;
 	TCCR5B = 0;
 	TIMSK5 = 0;
+	return 0;
 }
 
 #endif
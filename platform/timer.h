@@ -45,6 +45,13 @@ the source code.
 		USE_TIMER_X в ноль. Это позволит сократить объем программы, и уменьшить 
 		использования ОЗУ.
 	
+	Метод clear() объекта занимает таймер целиком (timer_claim.h) от имени
+	"timer_X": модули, которые позже попытаются занять этот таймер, получат
+	ошибку. Если таймер уже занят другим модулем, clear() не трогает регистры
+	и возвращает код timerClaim() меньше нуля; остальные методы объекта
+	тогда вызывать нельзя. Поэтому timer_claim.c нужно собирать вместе с
+	timer.c.
+	
 	Условная компиляция применяется и для управление ШИМ
 \code
 		#define USE_PWM_TIMER_0 		0 
@@ -198,7 +205,7 @@ typedef struct Timer0_class
 	void (*timerPWM_A)(PORT_MODE_t mode); 					//!< Включить ШИМ на вывод 19
 #endif
 	void (*setCNT)(uint8_t cnt); 							//!< Изменить значение счетчика
-	void (*clear)(); 										//!< Очистить регистры
+	int8_t (*clear)(); 										//!< Занять таймер и очистить регистры; < 0 -- таймер занят
 }Timer0_obj;
 
 /**
@@ -221,7 +228,7 @@ typedef struct Timer1_class
 	void (*timerPWM_A)(PORT_MODE_t mode); 					//!< ШИМ на выводе 41, только для таймера 1
 #endif
 	void (*setCNT)(uint16_t cnt); 							//!< Изменить значение счетчика
-	void (*clear)(); 										//!< Очистить регистры
+	int8_t (*clear)(); 										//!< Занять таймер и очистить регистры; < 0 -- таймер занят
 }Timer1_obj;
 
 /**
@@ -244,7 +251,7 @@ typedef struct Timer2_class
 	void (*async_mode_on)(); 								//!< Включения асинхронного режима от кварца 32 KHz
 	void (*async_mode_off)(); 								//!< Выключения асинхронного режима
 	void (*setCNT)(uint8_t cnt); 							//!< Изменить значение счетчика
-	void (*clear)(); 										//!< Очистить регистры
+	int8_t (*clear)(); 										//!< Занять таймер и очистить регистры; < 0 -- таймер занят
 }Timer2_obj;
 
 #if USE_TIMER_0
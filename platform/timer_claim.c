@@ -0,0 +1,99 @@
+/**
+\file timer_claim.c
+\author agent <agent@local>
+\brief Распределение аппаратных таймеров между модулями
+\details Таблица занятых каналов, предделителей и режимов таймеров 0..5.
+\version 0.1
+\date 18.10.2026
+\copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "timer.h"
+#include "timer_claim.h"
+
+/**
+\brief Состояние таймера
+*/
+typedef struct timer_claim
+{
+	uint8_t channels; 		//!< Занятые каналы
+	uint8_t users; 			//!< Количество модулей
+	CLOCK_t clk; 			//!< Предделитель первого модуля
+	TIMER_MODE_t mode; 		//!< Режим первого модуля
+	const char *owner; 		//!< Имя первого модуля
+}timer_claim_t;
+
+static timer_claim_t claims[TIMER_COUNT];
+
+int8_t timerClaim(uint8_t timer, uint8_t channels, CLOCK_t clk, TIMER_MODE_t mode, const char *owner)
+{
+	timer_claim_t *c;
+	int8_t result;
+	uint8_t sreg = SREG;
+
+	if (timer >= TIMER_COUNT)
+		return TIMER_CLAIM_NO_TIMER;
+	c = &claims[timer];
+
+	cli();
+	if (c->channels & channels)
+		result = TIMER_CLAIM_BUSY;
+	else if (!c->users)
+	{
+		c->clk = clk;
+		c->mode = mode;
+		c->owner = owner;
+		result = TIMER_CLAIM_FIRST;
+	}
+	else if ((c->clk != clk) || (c->mode != mode))
+		result = TIMER_CLAIM_MISMATCH;
+	else
+		result = TIMER_CLAIM_SHARED;
+
+	if (result >= 0)
+	{
+		c->channels |= channels;
+		c->users++;
+	}
+	SREG = sreg;
+	return result;
+}
+
+void timerRelease(uint8_t timer, uint8_t channels)
+{
+	timer_claim_t *c;
+	uint8_t sreg = SREG;
+
+	if (timer >= TIMER_COUNT)
+		return;
+	c = &claims[timer];
+
+	cli();
+	if (c->users && (c->channels & channels))
+	{
+		c->channels &= ~channels;
+		if (!--c->users)
+			c->owner = NULL;
+	}
+	SREG = sreg;
+}
+
+const char *timerOwner(uint8_t timer)
+{
+	if (timer >= TIMER_COUNT)
+		return NULL;
+	return claims[timer].owner;
+}
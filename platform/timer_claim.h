@@ -0,0 +1,99 @@
+/**
+\file timer_claim.h
+\author agent <agent@local>
+\brief Распределение аппаратных таймеров между модулями
+\details Модуль, которому нужен таймер, при инициализации занимает (claim)
+его каналы: компараторы A, B, C, захват и переполнение -- те же флаги, что и
+TIMER_xxx_INT в timer.h. Вместе с каналами указываются предделитель и режим
+таймера. Каналы одного таймера можно раздать разным модулям, если им нужны
+одинаковые предделитель и режим; иначе timerClaim() вернет ошибку, и
+конфликт виден при запуске, а не через неделю отладки.
+
+Конфликты, известные при сборке, ловит TIMER_CLAIM_STATIC(): два модуля,
+занявшие один канал, не соберутся -- компоновщик сообщит о повторном
+определении timer_claim_N_CH.
+\code{.c}
+	TIMER_CLAIM_STATIC(5, A)		// в .c модуля, вне функций
+
+	int8_t myInit(void)
+	{
+		int8_t r = timerClaim(5, TIMER_COMPARE_A_INT, CLK_DIV_64, NORMAL_MODE, "my");
+		if (r < 0)
+			return r;				// таймер занят несовместимо
+		if (r == TIMER_CLAIM_FIRST)
+			;						// первый пользователь: настраиваем таймер
+		...
+	}
+\endcode
+Занятые таймеры (по умолчанию):
+таймер 0 -- очередь LCD (LCD_USE_QUEUE), таймер 1 -- часы (clock.h),
+таймер 3 -- захват (capture.h), таймер 4 -- звук (sound.h),
+таймер 5 -- программные таймеры (swtimer.h). Объекты timer_N (timer.h)
+занимают таймер целиком в методе clear().
+\version 0.1
+\date 18.10.2026
+\copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+*/
+
+#ifndef TIMER_CLAIM_H_
+#define TIMER_CLAIM_H_
+
+#include <stdint.h>
+#include "timer.h"
+
+#define TIMER_COUNT			6		//!< Таймеры 0..5.
+
+/**
+\brief Результат timerClaim()
+*/
+#define TIMER_CLAIM_FIRST	0		//!< Таймер был свободен -- его нужно настроить
+#define TIMER_CLAIM_SHARED	1		//!< Таймер уже настроен совместимым модулем
+#define TIMER_CLAIM_BUSY	(-1)	//!< Канал уже занят
+#define TIMER_CLAIM_MISMATCH (-2)	//!< Другие предделитель или режим
+#define TIMER_CLAIM_NO_TIMER (-3)	//!< Нет такого таймера
+
+/**
+\brief Занять канал при сборке.
+\details Определяет функцию timer_claim_N_CH; второй такой же захват в
+программе приведет к ошибке компоновки.
+\param n Номер таймера.
+\param ch Канал: A, B, C, CAPT или OVF.
+*/
+#define TIMER_CLAIM_STATIC(n, ch)	TIMER_CLAIM_STATIC_(n, ch)
+#define TIMER_CLAIM_STATIC_(n, ch)	\
+	void timer_claim_##n##_##ch(void); void timer_claim_##n##_##ch(void) {}
+
+/**
+\brief Занять каналы таймера.
+\param timer Номер таймера (0..5).
+\param channels Каналы: TIMER_COMPARE_A_INT | ... ; TIMER_ALL_INT -- весь таймер.
+\param clk Предделитель, который нужен модулю.
+\param mode Режим таймера, который нужен модулю.
+\param owner Имя модуля (для диагностики).
+\return TIMER_CLAIM_FIRST, TIMER_CLAIM_SHARED или код ошибки (< 0).
+*/
+int8_t timerClaim(uint8_t timer, uint8_t channels, CLOCK_t clk, TIMER_MODE_t mode, const char *owner);
+
+/**
+\brief Освободить каналы таймера.
+\param timer Номер таймера.
+\param channels Каналы, занятые timerClaim().
+*/
+void timerRelease(uint8_t timer, uint8_t channels);
+
+/**
+\brief Кто занял таймер.
+\param timer Номер таймера.
+\return Имя первого модуля, занявшего таймер; NULL -- таймер свободен.
+*/
+const char *timerOwner(uint8_t timer);
+
+#endif /* TIMER_CLAIM_H_ */
@@ -0,0 +1,116 @@
+/**
+\file timer_inline.h
+\author agent <agent@local>
+\brief Встраиваемые функции управления таймерами
+\details Те же операции, что и у объектов timer_0..timer_5 (timer.h), но в
+виде static inline функций, своих для каждого таймера: timer0_start(),
+timer3_setCNT() и т.д. Номер таймера известен при компиляции, поэтому
+вызов превращается в прямое обращение к регистрам. Модуль не занимает ОЗУ
+и не требует timer.c; неиспользуемые функции в программу не попадают.
+\version 0.1
+\date 18.10.2026
+\copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+*/
+
+/*!
+	Сравнение в прерывании (avr-gcc -Os, ATmega128RFA1):
+
+\code
+	ISR(TIMER3_OVF_vect)
+	{
+		timer_3.setCNT(-8000);	// Объект timer.h
+	}
+\endcode
+	Указатель на функцию читается из ОЗУ (lds, lds -- 4 такта), затем
+	icall (3), в функции sts, sts (4) и ret (4). Главное -- компилятор не знает,
+	какие регистры портит вызываемая функция, и сохраняет в прерывании все
+	регистры, которые может испортить вызов (r18..r27, r30, r31): 12 пар
+	push/pop -- еще 48 тактов. Итого около 85 тактов на вход, тело и выход
+	из прерывания.
+
+\code
+	ISR(TIMER3_OVF_vect)
+	{
+		timer3_setCNT(-8000);	// timer_inline.h
+	}
+\endcode
+	Компилируется в ldi, ldi, sts, sts (6 тактов) и сохранение одного
+	регистра -- около 30 тактов вместе с входом и выходом из прерывания.
+	Кроме того, объекты timer_0..timer_5 занимают в ОЗУ по 20..28 байт
+	указателей.
+
+	Объекты и встраиваемые функции можно использовать в одной программе:
+	оба варианта работают с одними и теми же регистрами.
+*/
+
+#ifndef TIMER_INLINE_H_
+#define TIMER_INLINE_H_
+
+#include <avr/io.h>
+#include <stdint.h>
+#include "timer.h"
+
+/**
+\brief Функции 8-битного таймера n (0 или 2).
+*/
+#define TIMER8_INLINE(n)												\
+static inline void timer##n##_start(CLOCK_t clk)						\
+{	TCCR##n##B = (TCCR##n##B & ~CSx_BITS) | TO_INT(clk); }				\
+static inline void timer##n##_stop(void)								\
+{	TCCR##n##B &= ~CSx_BITS; }											\
+static inline uint8_t timer##n##_getCNT(void)							\
+{	return TCNT##n; }													\
+static inline void timer##n##_setCNT(uint8_t cnt)						\
+{	TCNT##n = cnt; }													\
+static inline void timer##n##_setInterrupt(uint8_t interrupt)			\
+{	TIMSK##n |= interrupt; }											\
+static inline void timer##n##_clearInterrupt(uint8_t interrupt)		\
+{	TIMSK##n &= ~interrupt; }											\
+static inline void timer##n##_setOCRA(uint8_t ocr)						\
+{	OCR##n##A = ocr; }													\
+static inline void timer##n##_setOCRB(uint8_t ocr)						\
+{	OCR##n##B = ocr; }													\
+static inline void timer##n##_clear(void)								\
+{	TCNT##n = 0; TCCR##n##A = 0; TCCR##n##B = 0; TIMSK##n = 0; }
+
+/**
+\brief Функции 16-битного таймера n (1, 3, 4 или 5).
+*/
+#define TIMER16_INLINE(n)												\
+static inline void timer##n##_start(CLOCK_t clk)						\
+{	TCCR##n##B = (TCCR##n##B & ~CSx_BITS) | TO_INT(clk); }				\
+static inline void timer##n##_stop(void)								\
+{	TCCR##n##B &= ~CSx_BITS; }											\
+static inline uint16_t timer##n##_getCNT(void)							\
+{	return TCNT##n; }													\
+static inline void timer##n##_setCNT(uint16_t cnt)						\
+{	TCNT##n = cnt; }													\
+static inline void timer##n##_setInterrupt(uint8_t interrupt)			\
+{	TIMSK##n |= interrupt; }											\
+static inline void timer##n##_clearInterrupt(uint8_t interrupt)		\
+{	TIMSK##n &= ~interrupt; }											\
+static inline void timer##n##_setOCRA(uint16_t ocr)					\
+{	OCR##n##A = ocr; }													\
+static inline void timer##n##_setOCRB(uint16_t ocr)					\
+{	OCR##n##B = ocr; }													\
+static inline void timer##n##_setOCRC(uint16_t ocr)					\
+{	OCR##n##C = ocr; }													\
+static inline void timer##n##_clear(void)								\
+{	TCNT##n = 0; TCCR##n##A = 0; TCCR##n##B = 0; TIMSK##n = 0; }
+
+TIMER8_INLINE(0)
+TIMER16_INLINE(1)
+TIMER8_INLINE(2)
+TIMER16_INLINE(3)
+TIMER16_INLINE(4)
+TIMER16_INLINE(5)
+
+#endif /* TIMER_INLINE_H_ */
@@ -0,0 +1,296 @@
+/**
+ \file owi_sim.c
+ \author agent <agent@local>
+ \brief Модель шины 1-Wire для проверки owi.c и ds18b20.c на компьютере.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <string.h>
+#include <avr/io.h>
+
+#include "owi_sim.h"
+
+#define OWI_BIT			(4)
+
+volatile uint8_t PORTB, DDRB, SREG;
+
+/**
+ \brief  Состояние устройств после сброса.
+ */
+enum
+{
+	DEV_IDLE = 0,		//!< Ждут сброса
+	DEV_CMD,			//!< Принимают команду ROM
+	DEV_SEARCH,			//!< Идет поиск
+	DEV_MATCH,			//!< Принимают адрес MATCH ROM
+	DEV_FUNC,			//!< Выбраны, принимают команду
+	DEV_READ,			//!< Выдают память
+	DEV_WRITE			//!< Принимают Th, Tl и конфигурацию
+};
+
+static uint8_t roms[SIM_MAX_DEVICES][8];
+static uint8_t alarm[SIM_MAX_DEVICES];
+static uint8_t active[SIM_MAX_DEVICES];		//!< Устройство участвует в поиске или выбрано.
+static uint8_t detached[SIM_MAX_DEVICES];
+static uint8_t scratch[SIM_MAX_DEVICES][9];
+static uint8_t wbuf[3];
+static uint8_t ndev;
+
+static uint8_t state;
+static uint8_t cmd, nbits;
+static uint8_t bit_index, phase;			//!< Бит адреса и слот (0 -- бит, 1 -- инверсия, 2 -- выбор).
+
+static double now;							//!< Модельное время, мкс.
+static double fall;							//!< Начало импульса мастера.
+static double rise;							//!< Конец импульса мастера.
+static uint8_t low;							//!< Мастер держит линию.
+static uint8_t level = 1;					//!< Ответ устройств в текущем слоте.
+static uint8_t presence;					//!< Последний импульс -- сброс.
+static uint8_t shorted;
+static uint16_t resets;
+
+void sim_reset(void)
+{
+	ndev = 0;
+	state = DEV_IDLE;
+	low = 0;
+	level = 1;
+	presence = 0;
+	shorted = 0;
+	resets = 0;
+	DDRB = PORTB = 0;
+}
+
+/**
+\brief CRC8 Dallas побитно. Внутренняя функция.
+*/
+static uint8_t crc8(const uint8_t *data, uint8_t len)
+{
+	uint8_t crc = 0, i, b;
+
+	while (len--)
+	{
+		b = *data++;
+		for (i = 0; i < 8; i++)
+		{
+			crc = ((crc ^ b) & 1) ? (crc >> 1) ^ 0x8C : (crc >> 1);
+			b >>= 1;
+		}
+	}
+	return crc;
+}
+
+void sim_add(const uint8_t *rom, uint8_t is_alarm)
+{
+	// Память после включения: 85 °C, Th = 75, Tl = 70, 12 бит.
+	static const uint8_t pad[8] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10 };
+
+	memcpy(roms[ndev], rom, 8);
+	alarm[ndev] = is_alarm;
+	detached[ndev] = 0;
+	memcpy(scratch[ndev], pad, 8);
+	scratch[ndev][8] = crc8(pad, 8);
+	ndev++;
+}
+
+void sim_detach(uint8_t dev, uint8_t on)
+{
+	detached[dev] = on;
+}
+
+void sim_set_temp(uint8_t dev, int16_t raw)
+{
+	scratch[dev][0] = raw;
+	scratch[dev][1] = (uint16_t)raw >> 8;
+	scratch[dev][8] = crc8(scratch[dev], 8);
+}
+
+const uint8_t *sim_scratchpad(uint8_t dev)
+{
+	return scratch[dev];
+}
+
+void sim_short(uint8_t on)
+{
+	shorted = on;
+}
+
+uint16_t sim_resets(void)
+{
+	return resets;
+}
+
+/**
+\brief Бит адреса устройства.
+*/
+static uint8_t romBit(uint8_t dev, uint8_t i)
+{
+	return (roms[dev][i / 8] >> (i % 8)) & 1;
+}
+
+/**
+\brief Мастер отпустил линию: разбираем импульс.
+\param width Длительность импульса, мкс.
+*/
+static void pulse(double width)
+{
+	uint8_t bit = (width < 15) ? 1 : 0;
+	uint8_t i, out;
+
+	level = 1;
+	presence = 0;
+	if (width >= 480)
+	{
+		resets++;
+		presence = 1;
+		state = DEV_CMD;
+		cmd = nbits = 0;
+		return;
+	}
+	if (state == DEV_CMD)
+	{
+		cmd |= bit << nbits;
+		if (++nbits < 8)
+			return;
+		state = DEV_IDLE;
+		for (i = 0; i < ndev; i++)
+			active[i] = !detached[i];
+		bit_index = phase = 0;
+		if ((cmd == 0xF0) || (cmd == 0xEC))
+		{
+			for (i = 0; i < ndev; i++)
+				active[i] &= (cmd == 0xF0) || alarm[i];
+			state = DEV_SEARCH;
+		}
+		else if (cmd == 0x55)
+			state = DEV_MATCH;
+		else if (cmd == 0xCC)
+		{
+			state = DEV_FUNC;
+			cmd = nbits = 0;
+		}
+		return;
+	}
+	if (state == DEV_MATCH)				// Остаются устройства с совпавшим битом.
+	{
+		for (i = 0; i < ndev; i++)
+			if (romBit(i, bit_index) != bit)
+				active[i] = 0;
+		if (++bit_index == 64)
+		{
+			state = DEV_FUNC;
+			cmd = nbits = 0;
+		}
+		return;
+	}
+	if (state == DEV_FUNC)
+	{
+		cmd |= bit << nbits;
+		if (++nbits < 8)
+			return;
+		bit_index = 0;
+		if (cmd == 0xBE)
+			state = DEV_READ;
+		else if (cmd == 0x4E)
+			state = DEV_WRITE;
+		else
+			state = DEV_IDLE;
+		return;
+	}
+	if (state == DEV_READ)				// Память, затем единицы.
+	{
+		if (bit_index < 72)
+			for (i = 0; i < ndev; i++)
+				if (active[i] && !((scratch[i][bit_index / 8] >> (bit_index % 8)) & 1))
+					level = 0;
+		bit_index++;
+		return;
+	}
+	if (state == DEV_WRITE)
+	{
+		if (!(bit_index % 8))
+			wbuf[bit_index / 8] = 0;
+		wbuf[bit_index / 8] |= bit << (bit_index % 8);
+		if (++bit_index < 24)
+			return;
+		for (i = 0; i < ndev; i++)
+		{
+			if (!active[i])
+				continue;
+			scratch[i][2] = wbuf[0];
+			scratch[i][3] = wbuf[1];
+			scratch[i][4] = (wbuf[2] & 0x60) | 0x1F;	// Записываются только R1:R0.
+			scratch[i][8] = crc8(scratch[i], 8);
+		}
+		state = DEV_IDLE;
+		return;
+	}
+	if (state != DEV_SEARCH)
+		return;
+	if (phase < 2)						// Устройства выдают бит или инверсию.
+	{
+		for (i = 0; i < ndev; i++)
+		{
+			if (!active[i])
+				continue;
+			out = romBit(i, bit_index) ^ phase;
+			if (!out)
+				level = 0;				// Монтажное И.
+		}
+		phase++;
+		return;
+	}
+	for (i = 0; i < ndev; i++)			// Мастер выбрал ветвь.
+		if (romBit(i, bit_index) != bit)
+			active[i] = 0;
+	phase = 0;
+	if (++bit_index == 64)
+		state = DEV_IDLE;
+}
+
+void sim_delay_us(double us)
+{
+	uint8_t held = (DDRB >> OWI_BIT) & 1;
+
+	if (held && !low)
+	{
+		low = 1;
+		fall = now;
+	}
+	else if (!held && low)
+	{
+		low = 0;
+		rise = now;
+		pulse(now - fall);
+	}
+	now += us;
+}
+
+uint8_t sim_pinb(void)
+{
+	uint8_t line = 1, i;
+
+	if (shorted || ((DDRB >> OWI_BIT) & 1))
+		line = 0;
+	else if (presence)
+	{
+		// Импульс присутствия: 15..240 мкс после сброса.
+		for (i = 0; i < ndev; i++)
+			if (!detached[i] && (now - rise >= 15) && (now - rise <= 240))
+				line = 0;
+	}
+	else if (now - fall < 60)
+		line = level;
+	return line ? (uint8_t)(1 << OWI_BIT) : 0;
+}
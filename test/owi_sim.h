@@ -0,0 +1,69 @@
+/**
+ \file owi_sim.h
+ \author agent <agent@local>
+ \brief Модель шины 1-Wire для проверки owi.c и ds18b20.c на компьютере.
+ \details Модель следит за выводом PB4 (DDRB) и модельным временем
+ (_delay_us): отпускание линии после 480 мкс -- сброс, после короткого
+ импульса -- слот "1" или чтения, после длинного -- слот "0". Устройства
+ понимают команды SEARCH ROM, ALARM SEARCH, MATCH ROM и SKIP ROM, а после
+ выбора -- READ SCRATCHPAD и WRITE SCRATCHPAD; остальные игнорируют.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef OWI_SIM_H_
+#define OWI_SIM_H_
+
+#include <stdint.h>
+
+#define SIM_MAX_DEVICES		(16)
+
+/**
+\brief Убрать все устройства с шины и сбросить модель.
+*/
+void sim_reset(void);
+
+/**
+\brief Подключить устройство.
+\param rom Адрес, 8 байт.
+\param alarm 1 -- устройство отвечает на ALARM SEARCH.
+*/
+void sim_add(const uint8_t *rom, uint8_t alarm);
+
+/**
+\brief Отключить устройство (1) или подключить обратно (0).
+\details Отключенное устройство не отвечает ни на что, в том числе на сброс.
+*/
+void sim_detach(uint8_t dev, uint8_t on);
+
+/**
+\brief Задать температуру устройства (код 1/16 °C) и пересчитать CRC памяти.
+*/
+void sim_set_temp(uint8_t dev, int16_t raw);
+
+/**
+\brief Память (SCRATCHPAD) устройства, 9 байт.
+*/
+const uint8_t *sim_scratchpad(uint8_t dev);
+
+/**
+\brief Закоротить шину на землю (1) или снять замыкание (0).
+*/
+void sim_short(uint8_t on);
+
+/**
+\brief Количество сбросов шины с момента sim_reset().
+*/
+uint16_t sim_resets(void);
+
+#endif /* OWI_SIM_H_ */
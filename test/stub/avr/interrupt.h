@@ -0,0 +1,13 @@
+/**
+ \file interrupt.h
+ \brief Заглушка <avr/interrupt.h> для сборки тестов на компьютере.
+ */
+
+#ifndef STUB_AVR_INTERRUPT_H_
+#define STUB_AVR_INTERRUPT_H_
+
+#define ISR(vector)		void vector(void)
+#define cli()
+#define sei()
+
+#endif /* STUB_AVR_INTERRUPT_H_ */
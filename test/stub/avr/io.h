@@ -0,0 +1,26 @@
+/**
+ \file io.h
+ \brief Заглушка <avr/io.h> для сборки тестов на компьютере.
+ \details Регистры -- обычные переменные. Чтение PINB отвечает модель шины
+ 1-Wire (owi_sim.c), регистры таймера 5 определяет test_swtimer.c.
+ */
+
+#ifndef STUB_AVR_IO_H_
+#define STUB_AVR_IO_H_
+
+#include <stdint.h>
+
+extern volatile uint8_t PORTB, DDRB;
+uint8_t sim_pinb(void);
+#define PINB	(sim_pinb())
+
+extern volatile uint8_t SREG;
+
+extern volatile uint16_t TCNT5, OCR5A;
+extern volatile uint8_t TCCR5A, TCCR5B, TIMSK5, TIFR5;
+#define CS50	0
+#define CS51	1
+#define OCIE5A	1
+#define OCF5A	1
+
+#endif /* STUB_AVR_IO_H_ */
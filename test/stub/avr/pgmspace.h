@@ -0,0 +1,15 @@
+/**
+ \file pgmspace.h
+ \brief Заглушка <avr/pgmspace.h> для сборки тестов на компьютере.
+ */
+
+#ifndef STUB_AVR_PGMSPACE_H_
+#define STUB_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)		(*(const uint8_t *)(addr))
+#define pgm_read_word(addr)		(*(const uint16_t *)(addr))
+
+#endif /* STUB_AVR_PGMSPACE_H_ */
@@ -0,0 +1,15 @@
+/**
+ \file delay.h
+ \brief Заглушка <util/delay.h> для сборки тестов на компьютере.
+ \details Задержки не ждут, а продвигают модельное время шины 1-Wire.
+ */
+
+#ifndef STUB_UTIL_DELAY_H_
+#define STUB_UTIL_DELAY_H_
+
+void sim_delay_us(double us);
+
+#define _delay_us(us)	sim_delay_us(us)
+#define _delay_ms(ms)	sim_delay_us((ms) * 1000.0)
+
+#endif /* STUB_UTIL_DELAY_H_ */
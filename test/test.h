@@ -0,0 +1,43 @@
+/**
+ \file test.h
+ \author agent <agent@local>
+ \brief Простейшие проверки для тестов на компьютере.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+
+static int test_failed, test_checked;
+
+/**
+ \brief  Проверка условия; при ошибке печатает файл, строку и условие.
+ */
+#define CHECK(cond)	do { \
+		test_checked++; \
+		if (!(cond)) { \
+			test_failed++; \
+			printf("%s:%d: FAIL: %s\n", __FILE__, __LINE__, #cond); \
+		} \
+	} while (0)
+
+/**
+ \brief  Итог: печатает счетчики и возвращает код завершения программы.
+ */
+#define TEST_RESULT(name)	(printf("%s: %d checks, %d failed\n", name, \
+		test_checked, test_failed), test_failed ? 1 : 0)
+
+#endif /* TEST_H_ */
@@ -0,0 +1,93 @@
+/**
+ \file test_lcdfb.c
+ \author agent <agent@local>
+ \brief Проверка экранного буфера (lcdfb.c).
+ \details lcdPutchar() и lcdPosition() заменены моделью экрана, контроллер
+ не нужен.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <string.h>
+
+#include "lcd.h"
+#include "lcdfb.h"
+#include "test.h"
+
+static char screen[2][8];				//!< Что показывает модель дисплея.
+
+uint8_t lcdPosition (lcd_t *lcd, uint8_t x, uint8_t y)
+{
+	lcd->cx = x;
+	lcd->cy = y;
+	return 0;
+}
+
+void lcdPutchar (lcd_t *lcd, char ch)
+{
+	screen[lcd->cy][lcd->cx++] = ch;
+}
+
+/**
+\brief Совпадает ли экран модели с буфером.
+*/
+static int same(lcdfb_t *fb)
+{
+	return !memcmp(screen, fb->buf, sizeof(screen));
+}
+
+static void testFlush(void)
+{
+	lcd_t lcd = { 2, 8, 0, 0, 0 };
+	lcdfb_t fb;
+
+	memset(screen, '?', sizeof(screen));
+	lcdfbInit(&fb, &lcd);
+	CHECK(lcdfbFlush(&fb) == 16);			// Первый вывод -- весь экран.
+	CHECK(same(&fb));
+	CHECK(lcdfbFlush(&fb) == 0);			// Ничего не изменилось.
+
+	lcdfbPosition(&fb, 3, 1);
+	lcdfbPutchar(&fb, 'A');
+	CHECK(lcdfbFlush(&fb) == 1);
+	CHECK(same(&fb));
+}
+
+/**
+\brief После lcdfbInvalidate() перерисовывается каждая ячейка, какой бы
+символ в нее ни записали (0xDF -- знак градуса -- это ~' ').
+*/
+static void testInvalidate(void)
+{
+	lcd_t lcd = { 2, 8, 0, 0, 0 };
+	lcdfb_t fb;
+	uint8_t x;
+
+	lcdfbInit(&fb, &lcd);
+	lcdfbFlush(&fb);
+	memset(screen, 0, sizeof(screen));		// Экран стерли в обход буфера.
+	lcdfbInvalidate(&fb);
+	lcdfbPosition(&fb, 0, 0);
+	for (x = 0; x < 8; x++)
+		lcdfbPutchar(&fb, (char)0xDF);
+	CHECK(lcdfbFlush(&fb) == 16);
+	CHECK(same(&fb));
+	CHECK(lcdfbFlush(&fb) == 0);
+}
+
+int main(void)
+{
+	testFlush();
+	testInvalidate();
+	return TEST_RESULT("test_lcdfb");
+}
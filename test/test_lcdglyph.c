@@ -0,0 +1,99 @@
+/**
+ \file test_lcdglyph.c
+ \author agent <agent@local>
+ \brief Проверка менеджера пользовательских символов (lcdglyph.c).
+ \details lcdCharDef() заменен записью загрузок, контроллер не нужен.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <string.h>
+
+#include "lcd.h"
+#include "lcdglyph.h"
+#include "test.h"
+
+static int uploads;
+static uint8_t cgram[8][8];
+
+void lcdCharDef (lcd_t *lcd, uint8_t index, uint8_t *data)
+{
+	uploads++;
+	memcpy(cgram[index & 7], data, 8);
+}
+
+/**
+\brief Изображение, заполненное одним байтом.
+*/
+static void fill(uint8_t *g, uint8_t v)
+{
+	memset(g, v, 8);
+}
+
+int main(void)
+{
+	lcd_t lcd;
+	uint8_t a[8], b[8], buf[8], code, codes[LCDGLYPH_SLOTS];
+	int i;
+
+	lcdGlyphReset();
+
+	// Одинаковое содержимое по разным адресам -- одна загрузка.
+	fill(a, 0x11);
+	fill(b, 0x11);
+	code = lcdGlyph(&lcd, a);
+	CHECK(uploads == 1);
+	CHECK(lcdGlyph(&lcd, b) == code);
+	CHECK(uploads == 1);
+	CHECK(!memcmp(cgram[code], a, 8));
+
+	// Один буфер с разным содержимым -- разные символы.
+	fill(buf, 0x22);
+	code = lcdGlyph(&lcd, buf);
+	fill(buf, 0x33);
+	CHECK(lcdGlyph(&lcd, buf) != code);
+	CHECK(uploads == 3);
+	CHECK(!memcmp(cgram[lcdGlyph(&lcd, buf)], buf, 8));
+	CHECK(uploads == 3);
+
+	// LRU: заполняем все ячейки, много раз используем первую,
+	// новое изображение вытесняет вторую (дольше всех не использованную).
+	lcdGlyphReset();
+	uploads = 0;
+	for (i = 0; i < LCDGLYPH_SLOTS; i++)
+	{
+		fill(buf, 0x40 + i);
+		codes[i] = lcdGlyph(&lcd, buf);
+	}
+	CHECK(uploads == LCDGLYPH_SLOTS);
+	fill(buf, 0x40);
+	for (i = 0; i < 1000; i++)			// Больше 255 обращений.
+		CHECK(lcdGlyph(&lcd, buf) == codes[0]);
+	fill(buf, 0x80);
+	CHECK(lcdGlyph(&lcd, buf) == codes[1]);
+	fill(buf, 0x42);					// Третья теперь самая старая.
+	for (i = 0; i < 300; i++)
+	{
+		fill(buf, 0x40);
+		lcdGlyph(&lcd, buf);
+		fill(buf, 0x80);
+		lcdGlyph(&lcd, buf);
+	}
+	fill(buf, 0x81);
+	CHECK(lcdGlyph(&lcd, buf) == codes[2]);
+	fill(buf, 0x40);
+	CHECK(lcdGlyph(&lcd, buf) == codes[0]);		// Не вытеснена.
+	CHECK(uploads == LCDGLYPH_SLOTS + 2);
+
+	return TEST_RESULT("test_lcdglyph");
+}
@@ -0,0 +1,348 @@
+/**
+ \file test_owi.c
+ \author agent <agent@local>
+ \brief Проверка поиска устройств 1-Wire и CRC8 датчика DS18B20.
+ \details Собирается вместе с owi.c и ds18b20.c (программные слоты) и
+ моделью шины owi_sim.c.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "owi.h"
+#include "ds18b20.h"
+#include "owi_sim.h"
+#include "test.h"
+
+/**
+\brief CRC8 Dallas побитно, по определению (полином 0x31, обратный 0x8C).
+*/
+static uint8_t crc8_ref(const uint8_t *data, uint8_t len)
+{
+	uint8_t crc = 0, i, b;
+
+	while (len--)
+	{
+		b = *data++;
+		for (i = 0; i < 8; i++)
+		{
+			crc = ((crc ^ b) & 1) ? (crc >> 1) ^ 0x8C : (crc >> 1);
+			b >>= 1;
+		}
+	}
+	return crc;
+}
+
+/**
+\brief Адрес с заданным семейством и серийным номером, с верной CRC.
+*/
+static void makeRom(uint8_t *rom, uint8_t family, uint64_t serial)
+{
+	uint8_t i;
+
+	rom[0] = family;
+	for (i = 1; i < 7; i++, serial >>= 8)
+		rom[i] = serial;
+	rom[7] = crc8_ref(rom, 7);
+}
+
+static void testCrc(void)
+{
+	// Пример из Maxim AN27: адрес 02 1C B8 01 00 00 00, CRC = A2.
+	uint8_t an27[8] = { 0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xA2 };
+	uint8_t b[1], buf[9];
+	unsigned i;
+
+	CHECK(ds18b20_crc8(an27, 7) == 0xA2);
+	CHECK(ds18b20_crc8(an27, 8) == 0);
+	an27[3] ^= 0x10;
+	CHECK(ds18b20_crc8(an27, 8) != 0);
+
+	for (i = 0; i < 256; i++)			// Таблица против побитного расчета.
+	{
+		b[0] = i;
+		CHECK(ds18b20_crc8(b, 1) == crc8_ref(b, 1));
+	}
+	srand(1);
+	for (i = 0; i < 100; i++)			// Память датчика: 8 байт и CRC.
+	{
+		unsigned j;
+		for (j = 0; j < 8; j++)
+			buf[j] = rand();
+		buf[8] = crc8_ref(buf, 8);
+		CHECK(ds18b20_crc8(buf, 8) == buf[8]);
+		CHECK(ds18b20_crc8(buf, 9) == 0);
+	}
+}
+
+/**
+\brief Полный перебор шины OWI_search(); проверяет, что каждый адрес найден один раз.
+*/
+static void searchAll(uint8_t cmd, uint8_t roms[][8], uint8_t n, const uint8_t *expect)
+{
+	uint8_t rom[8], seen[SIM_MAX_DEVICES] = { 0 };
+	uint8_t last = 0, found = 0, i, want = 0;
+
+	for (i = 0; i < n; i++)
+		want += expect[i];
+	do
+	{
+		last = OWI_search(cmd, rom, last);
+		if (last == OWI_SEARCH_ERROR)
+			break;
+		for (i = 0; i < n; i++)
+			if (!memcmp(rom, roms[i], 8))
+				break;
+		CHECK(i < n);					// Найден существующий адрес.
+		if (i < n)
+		{
+			CHECK(expect[i]);			// И он должен был ответить.
+			CHECK(!seen[i]);			// И только один раз.
+			seen[i] = 1;
+		}
+		found++;
+	} while (last && (found <= n));
+	CHECK(found == want);
+	if (!want)
+		CHECK(last == OWI_SEARCH_ERROR);
+}
+
+static void testSearch(void)
+{
+	uint8_t roms[6][8];
+	uint8_t all[6] = { 1, 1, 1, 1, 1, 1 };
+	uint8_t alarms[6] = { 0, 1, 0, 0, 1, 0 };
+	uint8_t none[6] = { 0 };
+	uint8_t rom[8], devs[6], i, n;
+
+	// Пустая шина: нет импульса присутствия.
+	sim_reset();
+	CHECK(OWI_presence() == 0);
+	CHECK(OWI_search(OWI_CMD_SEARCHROM, rom, 0) == OWI_SEARCH_ERROR);
+	CHECK(ds18b20_search() == 0);
+
+	// Одно устройство: один проход, коллизий нет.
+	sim_reset();
+	makeRom(roms[0], DS18B20_FAMILY_CODE, 0x0000123456ULL);
+	sim_add(roms[0], 0);
+	CHECK(OWI_presence() == 1);
+	CHECK(OWI_search(OWI_CMD_SEARCHROM, rom, 0) == 0);
+	CHECK(!memcmp(rom, roms[0], 8));
+
+	// Несколько устройств: адреса различаются в первом бите, в последних
+	// битах и в середине; два устройства другого семейства.
+	sim_reset();
+	makeRom(roms[0], DS18B20_FAMILY_CODE, 0x000000000001ULL);
+	makeRom(roms[1], DS18B20_FAMILY_CODE, 0x800000000001ULL);
+	makeRom(roms[2], DS18B20_FAMILY_CODE, 0x000000000002ULL);
+	makeRom(roms[3], 0x10, 0x000000000001ULL);		// DS18S20
+	makeRom(roms[4], DS18B20_FAMILY_CODE, 0x0000FF000000ULL);
+	makeRom(roms[5], 0x01, 0x123456789ABCULL);		// DS2401
+	for (i = 0; i < 6; i++)
+		sim_add(roms[i], alarms[i]);
+	searchAll(OWI_CMD_SEARCHROM, roms, 6, all);
+	searchAll(OWI_CMD_ALARMSEARCH, roms, 6, alarms);
+
+	// ds18b20_search() оставляет только DS18B20, в порядке поиска.
+	n = ds18b20_search();
+	CHECK(n == 4);
+	CHECK(ds18b20_count() == 4);
+	for (i = 0; i < n; i++)
+	{
+		CHECK(ds18b20_rom(i) != NULL);
+		CHECK(ds18b20_rom(i)[0] == DS18B20_FAMILY_CODE);
+		CHECK(ds18b20_crc8((uint8_t *)ds18b20_rom(i), 8) == 0);
+	}
+	CHECK(ds18b20_rom(n) == NULL);
+
+	// Тревога у датчиков 1 и 4 (оба DS18B20): находятся их номера в таблице.
+	n = ds18b20_alarm_search(devs, 6);
+	CHECK(n == 2);
+	for (i = 0; i < n; i++)
+		CHECK(!memcmp(ds18b20_rom(devs[i]), roms[1], 8) ||
+			!memcmp(ds18b20_rom(devs[i]), roms[4], 8));
+
+	// Тревоги нет ни у кого.
+	sim_reset();
+	for (i = 0; i < 6; i++)
+		sim_add(roms[i], 0);
+	searchAll(OWI_CMD_ALARMSEARCH, roms, 6, none);
+
+	// Все 16 адресов с общим началом: глубокое дерево коллизий.
+	sim_reset();
+	{
+		uint8_t many[SIM_MAX_DEVICES][8], yes[SIM_MAX_DEVICES];
+		for (i = 0; i < SIM_MAX_DEVICES; i++)
+		{
+			makeRom(many[i], DS18B20_FAMILY_CODE, 0xA5A5A5A50000ULL | ((uint64_t)i << 44) | i);
+			sim_add(many[i], 0);
+			yes[i] = 1;
+		}
+		searchAll(OWI_CMD_SEARCHROM, many, SIM_MAX_DEVICES, yes);
+		CHECK(ds18b20_search() == SIM_MAX_DEVICES);
+	}
+}
+
+/**
+\brief Поиск во время преобразования: опрос готовности больше не верен.
+*/
+static void testConvState(void)
+{
+	uint8_t rom[8], devs[1];
+
+	sim_reset();
+	makeRom(rom, DS18B20_FAMILY_CODE, 0x42);
+	sim_add(rom, 0);
+	// Модель отвечает "1" на проверку питания -- внешнее питание, опрос
+	// слотами чтения разрешен.
+	CHECK(ds18b20_convert() == 0);
+	CHECK(ds18b20_search() == 1);
+	CHECK(ds18b20_ready() == -1);		// Слот чтения после поиска -- не готовность.
+
+	CHECK(ds18b20_convert() == 0);
+	ds18b20_alarm_search(devs, 1);
+	CHECK(ds18b20_ready() == -1);
+
+	CHECK(ds18b20_convert() == 0);
+	CHECK(ds18b20_presence() == 1);
+	CHECK(ds18b20_ready() == -1);
+
+	CHECK(ds18b20_convert() == 0);
+	CHECK(ds18b20_ready() == 1);		// Без других команд -- опрос слотом.
+}
+
+/**
+\brief Номер устройства модели для датчика из таблицы ds18b20_search().
+*/
+static uint8_t simIndex(uint8_t roms[][8], uint8_t n, uint8_t dev)
+{
+	uint8_t i;
+
+	for (i = 0; i < n; i++)
+		if (!memcmp(roms[i], ds18b20_rom(dev), 8))
+			return i;
+	return 0xFF;
+}
+
+/**
+\brief READ SCRATCHPAD по адресу: полная память и быстрое чтение температуры.
+*/
+static void testReadScratchpad(void)
+{
+	uint8_t roms[3][8];
+	int16_t temps[3] = { 0x0191, -1, -0x0191 };	// 25,0625 °C; -0,0625 °C; -25,0625 °C.
+	ds18b20_memory_t mem;
+	int16_t t;
+	uint8_t i, dev;
+
+	sim_reset();
+	for (i = 0; i < 3; i++)
+	{
+		makeRom(roms[i], DS18B20_FAMILY_CODE, 0x1000 + i);
+		sim_add(roms[i], 0);
+		sim_set_temp(i, temps[i]);
+	}
+	CHECK(ds18b20_search() == 3);
+	for (dev = 0; dev < 3; dev++)
+	{
+		i = simIndex(roms, 3, dev);
+		CHECK(i < 3);
+		CHECK(ds18b20_read_dev(dev, &mem) == 0);
+		CHECK(!memcmp(&mem, sim_scratchpad(i), sizeof(mem)));
+		t = 0x7FFF;
+		CHECK(ds18b20_read_temp(dev, &t) == 0);	// В том числе код 0xFFFF.
+		CHECK(t == temps[i]);
+	}
+
+	// Датчик пропал, другие на шине отвечают на сброс: линия в единице.
+	dev = 0;
+	i = simIndex(roms, 3, dev);
+	sim_detach(i, 1);
+	CHECK(ds18b20_read_temp(dev, &t) == -1);
+	CHECK(ds18b20_read_dev(dev, &mem) == -3);
+	sim_detach(i, 0);
+	CHECK(ds18b20_read_temp(dev, &t) == 0);
+	CHECK(ds18b20_read_temp(3, &t) == -2);
+
+	for (i = 0; i < 3; i++)						// На шине никого.
+		sim_detach(i, 1);
+	CHECK(ds18b20_read_temp(1, &t) == -1);
+	CHECK(ds18b20_read_dev(1, &mem) == -1);
+}
+
+/**
+\brief WRITE SCRATCHPAD: ds18b20_config() и ds18b20_set_alarm().
+*/
+static void testWriteScratchpad(void)
+{
+	uint8_t roms[3][8];
+	const uint8_t *pad;
+	uint8_t i, dev;
+
+	sim_reset();
+	for (i = 0; i < 3; i++)
+	{
+		makeRom(roms[i], DS18B20_FAMILY_CODE, 0x2000 + i);
+		sim_add(roms[i], 0);
+	}
+	CHECK(ds18b20_search() == 3);
+
+	// Всем сразу (SKIP ROM).
+	CHECK(ds18b20_config(DS18B20_ALL, 50, 10, DS18B20_RES_10BIT, 0) == 0);
+	for (i = 0; i < 3; i++)
+	{
+		pad = sim_scratchpad(i);
+		CHECK((pad[2] == 50) && (pad[3] == 10) && (pad[4] == DS18B20_RES_10BIT));
+	}
+
+	// Одному датчику (MATCH ROM): остальные не меняются.
+	dev = 1;
+	CHECK(ds18b20_config(dev, 40, -10, DS18B20_RES_9BIT, 0) == 0);
+	for (i = 0; i < 3; i++)
+	{
+		pad = sim_scratchpad(i);
+		if (i == simIndex(roms, 3, dev))
+			CHECK((pad[2] == 40) && (pad[3] == (uint8_t)-10) && (pad[4] == DS18B20_RES_9BIT));
+		else
+			CHECK((pad[2] == 50) && (pad[3] == 10) && (pad[4] == DS18B20_RES_10BIT));
+	}
+	CHECK(ds18b20_conv_time(dev) < ds18b20_conv_time(0));
+
+	// Пороги всем: у каждого датчика остается свое разрешение.
+	CHECK(ds18b20_set_alarm(DS18B20_ALL, 30, -5) == 0);
+	for (i = 0; i < 3; i++)
+	{
+		pad = sim_scratchpad(i);
+		CHECK((pad[2] == 30) && (pad[3] == (uint8_t)-5));
+		CHECK(pad[4] == ((i == simIndex(roms, 3, dev)) ? DS18B20_RES_9BIT : DS18B20_RES_10BIT));
+		CHECK(!crc8_ref(pad, 9));
+	}
+
+	// Пороги одному.
+	CHECK(ds18b20_set_alarm(2, 20, 0) == 0);
+	pad = sim_scratchpad(simIndex(roms, 3, 2));
+	CHECK((pad[2] == 20) && (pad[3] == 0) && (pad[4] == DS18B20_RES_10BIT));
+	CHECK(ds18b20_set_alarm(3, 20, 0) == -2);
+}
+
+int main(void)
+{
+	testCrc();
+	testSearch();
+	testConvState();
+	testReadScratchpad();
+	testWriteScratchpad();
+	return TEST_RESULT("test_owi");
+}
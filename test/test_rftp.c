@@ -0,0 +1,239 @@
+/**
+ \file test_rftp.c
+ \author agent <agent@local>
+ \brief Проверка транспорта больших сообщений (rftp.c).
+ \details Драйвер радио и часы заменены моделью: rf_send() кладет кадр в
+ эфир, шаг модели доставляет кадры обратно в rftp_input(). Узел передает
+ сообщение сам себе -- передатчик и приемник rftp независимы.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <string.h>
+
+#include "rf.h"
+#include "clock.h"
+#include "rftp.h"
+#include "test.h"
+
+#define AIR_SIZE	(4)				//!< Очередь передачи модели, кадров.
+#define STEP_US		(1000)			//!< Шаг модели.
+
+static uint8_t air[AIR_SIZE][RF_FRAME_SIZE];
+static uint8_t air_len[AIR_SIZE];
+static uint8_t air_count;
+static uint32_t now;
+static unsigned sent[256];			//!< Отправлено кадров по типам.
+static int released;
+
+/**
+\brief Потерять ли кадр: тип и номер кадра этого типа.
+*/
+static int (*drop)(uint8_t type, unsigned n);
+
+int8_t clockInit(void)
+{
+	return 0;
+}
+
+uint32_t clockMicros(void)
+{
+	return now;
+}
+
+int8_t rf_send(const void *data, uint8_t len)
+{
+	if (!len || (len > RF_MAX_PAYLOAD))
+		return (-2);
+	if (air_count == AIR_SIZE)
+		return (-1);
+	memcpy(air[air_count], data, len);
+	air_len[air_count++] = len;
+	return 0;
+}
+
+uint8_t rf_tx_free(void)
+{
+	return AIR_SIZE - air_count;
+}
+
+void rf_release(rf_rx_frame_t *frame)
+{
+	released++;
+}
+
+/**
+\brief Шаг модели: доставить кадры из эфира, продвинуть время, rftp_task().
+*/
+static void step(void)
+{
+	static uint8_t copy[AIR_SIZE][RF_FRAME_SIZE], copy_len[AIR_SIZE];
+	rf_rx_frame_t f;
+	uint8_t i, n = air_count, type;
+	unsigned k;
+
+	memcpy(copy, air, sizeof(air));
+	memcpy(copy_len, air_len, sizeof(air_len));
+	air_count = 0;
+	for (i = 0; i < n; i++)
+	{
+		type = copy[i][0];
+		k = sent[type]++;
+		if (drop && drop(type, k))
+			continue;
+		memset(&f, 0, sizeof(f));
+		memcpy(f.psdu, copy[i], copy_len[i]);
+		f.data = f.psdu;
+		f.len = copy_len[i];
+		CHECK(rftp_input(&f) == 1);
+	}
+	now += STEP_US;
+	rftp_task();
+}
+
+static void reset(int (*d)(uint8_t, unsigned))
+{
+	air_count = 0;
+	memset(sent, 0, sizeof(sent));
+	drop = d;
+	rftp_init();
+}
+
+/**
+\brief Передать сообщение самому себе.
+\return Шагов модели до конца передачи и приема.
+*/
+static unsigned transfer(const uint8_t *msg, uint8_t *buf, uint32_t len)
+{
+	unsigned steps = 0;
+
+	memset(buf, 0, len);
+	rftp_listen(buf, len, NULL);
+	CHECK(rftp_send(msg, len) == 0);
+	CHECK(rftp_send(msg, len) == -1);		// Передача уже идет.
+	while (((rftp_tx_status() == RFTP_BUSY) || (rftp_rx_status() == RFTP_BUSY) ||
+		(rftp_rx_status() == RFTP_LISTEN)) && (steps < 100000))
+	{
+		step();
+		steps++;
+	}
+	return steps;
+}
+
+static int dropData(uint8_t type, unsigned n)
+{
+	if (type == 0xA2)
+		return (n % 5) == 3;
+	if (type == 0xA3)
+		return (n % 3) == 1;
+	return 0;
+}
+
+static int dropAfterStart(uint8_t type, unsigned n)
+{
+	return (type == 0xA2) || ((type == 0xA3) && n);	// Теряем все, кроме ответа на начало.
+}
+
+static uint8_t msg[10000], buf[10000];
+
+static void testClean(void)
+{
+	uint32_t len = 45 * RFTP_FRAG_SIZE + 17;
+
+	reset(NULL);
+	transfer(msg, buf, len);
+	CHECK(rftp_tx_status() == RFTP_DONE);
+	CHECK(rftp_rx_status() == RFTP_DONE);
+	CHECK(rftp_rx_length() == len);
+	CHECK(!memcmp(msg, buf, len));
+	CHECK(sent[0xA2] == 46);				// Без потерь -- без повторов.
+}
+
+static void testLossy(void)
+{
+	uint32_t len = sizeof(msg);
+
+	reset(dropData);
+	transfer(msg, buf, len);
+	CHECK(rftp_tx_status() == RFTP_DONE);
+	CHECK(rftp_rx_status() == RFTP_DONE);
+	CHECK(!memcmp(msg, buf, len));
+}
+
+static void testShort(void)
+{
+	reset(NULL);
+	transfer(msg, buf, 1);
+	CHECK(rftp_rx_status() == RFTP_DONE);
+	CHECK(buf[0] == msg[0]);
+	CHECK(rftp_send(msg, 0) == -2);
+	CHECK(rftp_send(msg, RFTP_MAX_LENGTH + 1) == -2);
+}
+
+/**
+\brief Передатчик пропал после начала: прием прерывается по тайм-ауту.
+*/
+static void testRxTimeout(void)
+{
+	uint32_t t0;
+
+	reset(dropAfterStart);
+	rftp_listen(buf, sizeof(buf), NULL);
+	CHECK(rftp_send(msg, sizeof(msg)) == 0);
+	step();
+	step();
+	CHECK(rftp_rx_status() == RFTP_BUSY);
+	t0 = now;
+	while ((rftp_rx_status() == RFTP_BUSY) && (now - t0 < 10 * RFTP_RX_TIMEOUT_MS * 1000UL))
+		step();
+	CHECK(rftp_rx_status() == RFTP_FAILED);
+	CHECK(now - t0 <= RFTP_RX_TIMEOUT_MS * 1000UL);
+	CHECK(now - t0 > RFTP_TIMEOUT_MS * 1000UL * RFTP_RETRIES);
+	while (rftp_tx_status() == RFTP_BUSY)
+		step();
+	CHECK(rftp_tx_status() == RFTP_FAILED);
+	rftp_listen(buf, sizeof(buf), NULL);	// Новый прием после ошибки.
+	CHECK(rftp_rx_status() == RFTP_LISTEN);
+}
+
+/**
+\brief Кадры приложения (первый байт не 0xA1..0xA3) остаются приложению.
+*/
+static void testForeign(void)
+{
+	uint8_t d[4] = { 0x01, 'a', 0xA2, 0 };
+	rf_rx_frame_t f;
+
+	reset(NULL);
+	released = 0;
+	f.data = d;
+	f.len = sizeof(d);
+	CHECK(rftp_input(&f) == 0);
+	f.len = 0;
+	CHECK(rftp_input(&f) == 0);
+	CHECK(released == 0);
+}
+
+int main(void)
+{
+	unsigned i;
+
+	for (i = 0; i < sizeof(msg); i++)
+		msg[i] = i * 7 + (i >> 8);
+	testClean();
+	testLossy();
+	testShort();
+	testRxTimeout();
+	testForeign();
+	return TEST_RESULT("test_rftp");
+}
@@ -0,0 +1,143 @@
+/**
+ \file test_swtimer.c
+ \author agent <agent@local>
+ \brief Проверка программных таймеров (swtimer.c).
+ \details Таймер 5 заменен счетчиком: время идет по одному отсчету, при
+ совпадении с OCR5A и разрешенном прерывании вызывается обработчик.
+ \version   0.1
+ \date 18.10.2026
+ \copyright
+Это программное обеспечение распространяется под лицензией BSD 2-ух пунктов.
+Эта лицензия дает все права на использование и распространение программы в
+двоичном виде или в виде исходного кода, при условии, что в исходном коде
+сохранится указание авторских прав.
+
+This software is licensed under the simplified BSD license. This license
+gives everyone the right to use and distribute the code, either in binary or
+source code format, as long as the copyright license is retained in
+the source code.
+ */
+
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "swtimer.h"
+#include "test.h"
+
+#define TICK_CNT	(F_CPU / 64 / (1000000UL / SWTIMER_TICK_US))
+
+volatile uint8_t SREG;
+volatile uint16_t TCNT5, OCR5A;
+volatile uint8_t TCCR5A, TCCR5B, TIMSK5, TIFR5;
+
+void TIMER5_COMPA_vect(void);
+
+static uint32_t ticks;			//!< Время модели, такты.
+static uint32_t fired[4][8];	//!< Такты срабатываний каждого таймера.
+static uint8_t nfired[4];
+
+static void cb(void *arg)
+{
+	uint8_t n = (uint8_t)(uintptr_t)arg;
+
+	if (nfired[n] < 8)
+		fired[n][nfired[n]] = ticks;
+	nfired[n]++;
+}
+
+static swtimer_t tm[4] = {
+	SWTIMER_INIT(cb, (void *)0), SWTIMER_INIT(cb, (void *)1),
+	SWTIMER_INIT(cb, (void *)2), SWTIMER_INIT(cb, (void *)3),
+};
+
+/**
+\brief Время идет на n тактов.
+*/
+static void run(uint32_t n)
+{
+	uint32_t c;
+
+	for (; n; n--)
+	{
+		ticks++;
+		for (c = 0; c < TICK_CNT; c++)
+		{
+			TCNT5++;
+			if ((TIMSK5 & (1 << OCIE5A)) && (TCNT5 == OCR5A))
+				TIMER5_COMPA_vect();
+		}
+	}
+}
+
+static void reset(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < 4; i++)
+		nfired[i] = 0;
+	CHECK(swtimerInit() == 0);
+}
+
+static void testOneShot(void)
+{
+	uint32_t t0;
+
+	reset();
+	t0 = ticks;
+	swtimerStart(&tm[0], 5, 0);
+	swtimerStart(&tm[1], 5 + SWTIMER_SLOTS, 0);	// Та же ячейка, следующий оборот.
+	run(100);
+	CHECK(nfired[0] == 1);
+	CHECK(fired[0][0] - t0 == 5);
+	CHECK(nfired[1] == 1);
+	CHECK(fired[1][0] - fired[0][0] == SWTIMER_SLOTS);
+	CHECK(!(TIMSK5 & (1 << OCIE5A)));		// Колесо пусто -- прерываний нет.
+}
+
+static void testPeriodic(void)
+{
+	uint32_t t0;
+
+	reset();
+	t0 = ticks;
+	swtimerStart(&tm[2], 3, 7);
+	run(30);
+	CHECK(nfired[2] == 4);						// 3, 10, 17, 24
+	CHECK(fired[2][0] - t0 == 3);
+	CHECK(fired[2][3] - fired[2][0] == 21);
+	swtimerStop(&tm[2]);
+	run(30);
+	CHECK(nfired[2] == 4);
+}
+
+/**
+\brief Повторный swtimerInit() останавливает запущенные таймеры.
+\details Таймеры 0 и 1 лежат в одной ячейке. После swtimerInit() таймер 2
+занимает ту же ячейку, затем перезапускается таймер 0: он не должен
+вернуть в колесо таймер 1 и потерять таймер 2.
+*/
+static void testReinit(void)
+{
+	reset();
+	swtimerStart(&tm[1], 4, 0);
+	swtimerStart(&tm[0], 4, 0);
+	CHECK(swtimerInit() == 0);
+	CHECK(tm[0].slot == SWTIMER_IDLE);
+	CHECK(tm[1].slot == SWTIMER_IDLE);
+	swtimerStart(&tm[2], 4, 0);
+	swtimerStart(&tm[0], 4, 0);
+	run(50);
+	CHECK(nfired[0] == 1);
+	CHECK(nfired[1] == 0);
+	CHECK(nfired[2] == 1);
+	swtimerStop(&tm[1]);						// Остановка не запущенного -- без последствий.
+	CHECK(tm[1].slot == SWTIMER_IDLE);
+}
+
+int main(void)
+{
+	testOneShot();
+	testPeriodic();
+	testReinit();
+	return TEST_RESULT("test_swtimer");
+}